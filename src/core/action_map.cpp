@@ -0,0 +1,209 @@
+#include "action_map.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include "log.h"
+
+namespace Dawn
+{
+	namespace
+	{
+		struct InputName
+		{
+			const char* name;
+			uint32 code;
+		};
+
+		// mouse buttons are offset by Input::NUM_KEYS, the index space of the
+		// compiled table; the keys come from the list the Input enum is made of
+		const InputName INPUT_NAMES[] =
+		{
+			{ "MOUSE_LEFT_BUTTON", Input::NUM_KEYS + Input::MOUSE_LEFT_BUTTON },
+			{ "MOUSE_MIDDLE_BUTTON", Input::NUM_KEYS + Input::MOUSE_MIDDLE_BUTTON },
+			{ "MOUSE_RIGHT_BUTTON", Input::NUM_KEYS + Input::MOUSE_RIGHT_BUTTON },
+#define DAWN_INPUT_KEY_NAME(name, code) { #name, Input::name },
+			DAWN_INPUT_KEYS(DAWN_INPUT_KEY_NAME)
+#undef DAWN_INPUT_KEY_NAME
+		};
+
+		bool findInput(const std::string& name, uint32& code)
+		{
+			for(auto& input : INPUT_NAMES)
+			{
+				if(name == input.name)
+				{
+					code = input.code;
+					return true;
+				}
+			}
+
+			return false;
+		}
+	}
+
+	bool ActionMap::load(const std::string& path)
+	{
+		std::ifstream file(path);
+		if(!file)
+		{
+			DAWN_INTERNAL_ERROR("Couldn't open action map {}", path);
+			return false;
+		}
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+		return parse(contents.str().c_str());
+	}
+
+	bool ActionMap::parse(const char* json)
+	{
+		rapidjson::Document document;
+		document.Parse(json);
+		if(document.HasParseError())
+		{
+			DAWN_INTERNAL_ERROR("Action map parse error at {}: {}", document.GetErrorOffset(),
+			                    rapidjson::GetParseError_En(document.GetParseError()));
+			return false;
+		}
+
+		if(!document.IsObject())
+		{
+			DAWN_INTERNAL_ERROR("Action map has to be an object of action names");
+			return false;
+		}
+
+		bool isValid = true;
+		for(auto& member : document.GetObject())
+		{
+			ActionId action = addAction(member.name.GetString());
+			if(action == INVALID_ACTION)
+			{
+				isValid = false;
+				continue;
+			}
+
+			unbind(action);
+			if(member.value.IsString())
+			{
+				isValid &= bind(action, member.value.GetString());
+				continue;
+			}
+
+			if(!member.value.IsArray())
+			{
+				DAWN_INTERNAL_ERROR("Action {} has to be bound to a combo or an array of them", member.name.GetString());
+				isValid = false;
+				continue;
+			}
+
+			for(auto& combo : member.value.GetArray())
+				isValid &= combo.IsString() && bind(action, combo.GetString());
+		}
+
+		return isValid;
+	}
+
+	ActionId ActionMap::addAction(const std::string& name)
+	{
+		ActionId action = getAction(name);
+		if(action != INVALID_ACTION)
+			return action;
+
+		if(m_actions.size() == MAX_ACTIONS)
+		{
+			DAWN_INTERNAL_ERROR("Can't add action {}, all {} are taken", name, (uint32)MAX_ACTIONS);
+			return INVALID_ACTION;
+		}
+
+		m_actions.push_back(name);
+		return (ActionId)(m_actions.size() - 1);
+	}
+
+	ActionId ActionMap::getAction(const std::string& name) const
+	{
+		auto it = std::find(m_actions.begin(), m_actions.end(), name);
+		return it != m_actions.end() ? (ActionId)(it - m_actions.begin()) : INVALID_ACTION;
+	}
+
+	bool ActionMap::parseCombo(const std::string& combo, Binding& binding)
+	{
+		std::fill(binding.inputs, binding.inputs + MAX_COMBO, (uint16)ALWAYS_SET);
+
+		uint32 count = 0;
+		size_t begin = 0;
+		while(begin <= combo.size())
+		{
+			size_t end = std::min(combo.find('+', begin), combo.size());
+			uint32 code = 0;
+			if(count == MAX_COMBO || !findInput(combo.substr(begin, end - begin), code))
+				return false;
+
+			binding.inputs[count++] = (uint16)code;
+			begin = end + 1;
+		}
+
+		return true;
+	}
+
+	bool ActionMap::bind(ActionId action, const std::string& combo)
+	{
+		Binding binding;
+		binding.action = action;
+		if(action >= m_actions.size() || !parseCombo(combo, binding))
+		{
+			DAWN_INTERNAL_ERROR("Can't bind \"{}\"", combo);
+			return false;
+		}
+
+		m_bindings.push_back(binding);
+		return true;
+	}
+
+	void ActionMap::unbind(ActionId action)
+	{
+		m_bindings.erase(std::remove_if(m_bindings.begin(), m_bindings.end(), [action](const Binding& binding){
+			return binding.action == action;
+		}), m_bindings.end());
+	}
+
+	void ActionMap::update(const InputState& inputState)
+	{
+		const uint64* keysDown = inputState.getKeysDown();
+		const uint64* keysPressed = inputState.getKeysPressed();
+		for(uint32 i = 0; i < InputState::KEY_WORDS; i++)
+			m_activeInputs[i] = keysDown[i] | keysPressed[i];
+
+		const uint64* buttonsDown = inputState.getMouseButtonsDown();
+		const uint64* buttonsPressed = inputState.getMouseButtonsPressed();
+		for(uint32 i = 0; i < InputState::BUTTON_WORDS; i++)
+			m_activeInputs[InputState::KEY_WORDS + i] = buttonsDown[i] | buttonsPressed[i];
+
+		m_activeInputs[INPUT_WORDS - 1] = ~(uint64)0;
+
+		uint64 down = 0;
+		for(auto& binding : m_bindings)
+		{
+			uint64 isHeld = 1;
+			for(uint32 i = 0; i < MAX_COMBO; i++)
+				isHeld &= m_activeInputs[binding.inputs[i] >> 6] >> (binding.inputs[i] & 63);
+
+			down |= (isHeld & 1) << binding.action;
+		}
+
+		m_pressed = down & ~m_down;
+		m_released = m_down & ~down;
+		m_down = down;
+	}
+
+	ActionStates ActionMap::getStates() const
+	{
+		ActionStates states;
+		states.down = m_down;
+		states.pressed = m_pressed;
+		states.released = m_released;
+		return states;
+	}
+}
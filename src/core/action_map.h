@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "common.h"
+#include "input_state.h"
+
+namespace Dawn
+{
+	// index of an action in its ActionMap, stable across rebinding
+	typedef uint32 ActionId;
+
+	struct ActionStates;
+
+	// Binds named actions to key and mouse button combos. The bindings are
+	// compiled into a flat table of input bit indices, so resolving every
+	// action is a few bit tests per binding against the InputState bitsets,
+	// and an action's state is one bit of a 64 bit mask. Game code asks for
+	// its ActionId once and keeps it, rebinding only rebuilds the table.
+	//
+	// Config file, a JSON object of action names to combos, e.g.
+	//   { "jump": ["KEY_SPACE", "KEY_UP"], "save": "KEY_LCTRL+KEY_S" }
+	// A combo is up to MAX_COMBO Input names joined with '+', all of which
+	// have to be held.
+	class ActionMap
+	{
+	public:
+		static const uint32 MAX_ACTIONS = 64;
+		static const uint32 MAX_COMBO = 4;
+		static const ActionId INVALID_ACTION = 0xffffffff;
+
+	private:
+		// keys first, mouse buttons from Input::NUM_KEYS on, then one bit that's always set
+		static const uint32 ALWAYS_SET = Input::NUM_KEYS + Input::NUM_MOUSEBUTTONS;
+		static const uint32 INPUT_WORDS = InputState::KEY_WORDS + InputState::BUTTON_WORDS + 1;
+
+		struct Binding
+		{
+			ActionId action;
+			// unused entries are ALWAYS_SET
+			uint16 inputs[MAX_COMBO];
+		};
+
+		std::vector<std::string> m_actions{};
+		std::vector<Binding> m_bindings{};
+
+		uint64 m_activeInputs[INPUT_WORDS]{};
+		uint64 m_down{};
+		uint64 m_pressed{};
+		uint64 m_released{};
+
+		static bool parseCombo(const std::string& combo, Binding& binding);
+
+		static inline bool testBit(uint64 bits, ActionId action) { return ((bits >> (action & (MAX_ACTIONS - 1))) & 1) != 0; }
+
+		DAWN_NULL_COPY_AND_ASSIGN(ActionMap)
+	public:
+		ActionMap() {}
+		~ActionMap() {}
+
+		// Adds the file's bindings, replacing those of the actions it names.
+		bool load(const std::string& path);
+		bool parse(const char* json);
+
+		// Returns the existing id when the action is known already.
+		ActionId addAction(const std::string& name);
+		ActionId getAction(const std::string& name) const;
+
+		// Adds a combo to the action, false if it doesn't parse.
+		bool bind(ActionId action, const std::string& combo);
+		// Removes every combo of the action, the id stays valid.
+		void unbind(ActionId action);
+
+		// Once per frame after the events are drained. A key tapped within
+		// the frame counts as held for it.
+		void update(const InputState& inputState);
+
+		inline bool isActionDown(ActionId action) const { return testBit(m_down, action); }
+		inline bool wasActionPressed(ActionId action) const { return testBit(m_pressed, action); }
+		inline bool wasActionReleased(ActionId action) const { return testBit(m_released, action); }
+		// Copy of what the last update() resolved.
+		ActionStates getStates() const;
+
+		inline uint32 getActionCount() const { return (uint32)m_actions.size(); }
+		inline uint32 getBindingCount() const { return (uint32)m_bindings.size(); }
+	};
+
+	// Action bits of one frame, for code that can't query the ActionMap
+	// itself, such as the simulation thread of a pipelined frame.
+	struct ActionStates
+	{
+		uint64 down{};
+		uint64 pressed{};
+		uint64 released{};
+
+		inline bool isActionDown(ActionId action) const { return ((down >> (action & (ActionMap::MAX_ACTIONS - 1))) & 1) != 0; }
+		inline bool wasActionPressed(ActionId action) const { return ((pressed >> (action & (ActionMap::MAX_ACTIONS - 1))) & 1) != 0; }
+		inline bool wasActionReleased(ActionId action) const { return ((released >> (action & (ActionMap::MAX_ACTIONS - 1))) & 1) != 0; }
+	};
+}
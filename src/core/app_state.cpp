@@ -3,91 +3,288 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <fstream>
 #include "app_state.h"
 #include "spritebatch.h"
+#include "graphics/texture_manager.h"
+#include "graphics/overdraw_heatmap.h"
+#include "graphics/debug_draw.h"
 #include "log.h"
+#include "events/event_queue.h"
 
 namespace Dawn
 {
 
-const stbi_uc* pixels{};
+TextureHandle g_texture{};
+// known from the file header, before the texture is resident
+bool g_isTextureOpaque{};
+InterpolatedTransform g_spriteTransform{};
+glm::vec2 g_spriteVelocity{120.0f, 0.0f};
 
-SpriteBatch g_spriteBatch{};
-uint32 g_texture{};
+const glm::vec2 SPRITE_SIZE{32.0f, 32.0f};
+// threads helping the GL thread bin the lights of a frame
+const uint32 LIGHT_CULLING_WORKERS = 2;
 
-void glInit()
+// snapshots record TextureManager handles, they become GL textures at submission
+GLuint resolveTexture(GLuint handle)
 {
+    return TextureManager::getTextureManager().acquire(handle);
+}
+
+void AppState::initRenderer(uint32 width, uint32 height)
+{
+    m_windowWidth = width;
+    m_windowHeight = height;
+
     stbi_set_flip_vertically_on_load(false);
-    
-    int x, y, n;
-    pixels = stbi_load("hello.png", &x, &y, &n, 0);
-    DAWN_ASSERT(pixels != nullptr, "ERROR loading texture");
-    
-    glGenTextures(1, &g_texture);
-    glBindTexture(GL_TEXTURE_2D, g_texture);
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, x, y, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels);
-
-    g_spriteBatch.begin();
-    g_spriteBatch.add(g_texture, glm::vec2(20.0f, 20.0f), glm::vec2(32.0f, 32.0f));
-};
-    
-AppState * AppState::create()
-{
-    return new AppState();
-}
-
-void AppState::init(const std::string& title, Dawn::uint32 width, Dawn::uint32 height)
-{
-   bool success = SDL_Init(SDL_INIT_EVERYTHING);
-   DAWN_INTERNAL_ASSERT(success == 0, "SDL not initialized");
-    
-   SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-   SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
-   SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
-   
-   m_sdlWindow = SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, SDL_WINDOW_OPENGL);
-   DAWN_INTERNAL_ASSERT(m_sdlWindow != nullptr, "Couldn't create SDL window");
-   
-   SDL_ShowWindow(m_sdlWindow);
-   
-   m_windowContext = SDL_GL_CreateContext(m_sdlWindow);
-   DAWN_INTERNAL_ASSERT(m_windowContext != nullptr, "Couldn't create valid OpenGL context");
-   
-   success = gladLoadGLES2Loader(SDL_GL_GetProcAddress);
-   DAWN_INTERNAL_ASSERT(success != 0, "Couldn't initialize glad");
-   
-   SDL_GL_MakeCurrent(m_sdlWindow, m_windowContext);
-   SDL_GL_SwapWindow(m_sdlWindow);
-   
-   glInit();
-}
-
-void AppState::execute()
-{
-    while(isOpen())
+
+    TextureManager& textureManager = TextureManager::getTextureManager();
+    // decoded and uploaded in the background, the sprite shows up once it's resident
+    g_texture = textureManager.loadAsync("hello.png");
+    DAWN_ASSERT(g_texture != TextureManager::INVALID_HANDLE, "ERROR loading texture");
+    g_isTextureOpaque = textureManager.isOpaque(g_texture);
+
+    g_spriteTransform.reset(glm::vec2(20.0f, 20.0f));
+    m_lightCuller.init(LIGHT_CULLING_WORKERS);
+
+    m_toggleDynamicResolution = m_actionMap.addAction("toggle_dynamic_resolution");
+    m_actionMap.bind(m_toggleDynamicResolution, "KEY_F4");
+    if(std::ifstream("actions.json"))
+        m_actionMap.load("actions.json");
+
+    DAWN_DEBUG_DRAW_VIEWPORT(width, height);
+}
+
+void AppState::updateTimers()
+{
+    auto elapsed = std::chrono::steady_clock::now() - m_clockStart;
+    m_timers.advance((uint64)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+void AppState::updateActions()
+{
+    m_actionMap.update(InputState::getInputState());
+
+    if(m_actionMap.wasActionPressed(m_toggleDynamicResolution))
+        m_dynamicResolution.setEnabled(!m_dynamicResolution.isEnabled());
+}
+
+void AppState::captureInput(FrameInput& input)
+{
+    // measured every frame, so the first one after a replay doesn't span it
+    input.frameSeconds = m_fixedTimestep.measureFrame();
+    // recorded frame times while recording or replaying, so both step alike
+    double inputFrameSeconds = EventQueue::getEventQueue().getInputFrameSeconds();
+    if(inputFrameSeconds > 0.0)
+        input.frameSeconds = inputFrameSeconds;
+    input.windowWidth = m_windowWidth;
+    input.windowHeight = m_windowHeight;
+    input.inputState = InputState::getInputState();
+    input.actions = m_actionMap.getStates();
+}
+
+void AppState::simulateFrame(FrameSnapshot& snapshot)
+{
+    // only the captured input, the main thread is already past this frame while pipelined;
+    // beginFrame() also picks up timestep settings changed since the last frame
+    const FrameInput& input = snapshot.input;
+    uint32 steps = m_fixedTimestep.beginFrame(input.frameSeconds);
+    float stepSeconds = m_fixedTimestep.getStepSeconds();
+
+    for(uint32 i = 0; i < steps; i++)
+        simulate(stepSeconds, input);
+
+    snapshot.viewportWidth = input.windowWidth;
+    snapshot.viewportHeight = input.windowHeight;
+
+    Sprite sprite{};
+    sprite.texture = g_texture;
+    sprite.pos = g_spriteTransform.get(m_fixedTimestep.getAlpha());
+    sprite.size = SPRITE_SIZE;
+    sprite.depth = 0.5f;
+    sprite.isOpaque = g_isTextureOpaque;
+    snapshot.sprites.push_back(sprite);
+
+    // carried by the sprite
+    PointLight light{};
+    light.pos = sprite.pos + SPRITE_SIZE * 0.5f;
+    light.radius = 160.0f;
+    light.color = glm::vec3(1.0f, 0.9f, 0.7f);
+    light.intensity = 1.5f;
+    snapshot.lights.push_back(light);
+
+    // debug shapes added for this frame travel with it through the pipeline
+    DAWN_DEBUG_DRAW_TAKE(snapshot.debugPrimitives);
+}
+
+void AppState::simulate(float stepSeconds, const FrameInput& input)
+{
+    g_spriteTransform.beginStep();
+
+    // bounces the sample sprite between the window edges
+    glm::vec2& pos = g_spriteTransform.current;
+    pos += g_spriteVelocity * stepSeconds;
+    float width = (float)input.windowWidth;
+    if(pos.x < 0.0f || pos.x + SPRITE_SIZE.x > width)
+    {
+        g_spriteVelocity.x = -g_spriteVelocity.x;
+        pos.x = glm::clamp(pos.x, 0.0f, width - SPRITE_SIZE.x);
+    }
+}
+
+void AppState::submitFrame(PipelineFrame& frame)
+{
+    TextureManager::getTextureManager().beginFrame();
+
+    // the scene goes through the dynamic resolution target, debug overlays
+    // are drawn after the upscale at window resolution
+    m_dynamicResolution.beginFrame(m_windowWidth, m_windowHeight);
+    glClearColor(0, 0.75, 0.25, 1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    if(frame.snapshot.lights.empty() || m_windowWidth == 0)
+    {
+        frame.batch.setLighting(nullptr);
+    }
+    else
     {
-       glClearColor(0, 0.75, 0.25, 1);
-       glClear(GL_COLOR_BUFFER_BIT);
-       g_spriteBatch.end();
-       SDL_GL_SwapWindow(m_sdlWindow);
+        // tiles are cut in pixels of the scaled target the scene is drawn into
+        const DynamicResolutionStats& resolution = m_dynamicResolution.getStats();
+        m_lightCuller.setViewport(resolution.renderWidth, resolution.renderHeight);
+        m_lightCuller.setPixelScale((float)resolution.renderWidth / m_windowWidth);
+        m_lightCuller.cull(frame.snapshot.lights);
+        m_lightCuller.upload();
+        frame.batch.setLighting(&m_lightCuller);
     }
+
+    frame.batch.setTextureResolver(resolveTexture);
+    frame.batch.flush();
+    m_dynamicResolution.endFrame();
+
+    DAWN_DEBUG_DRAW_FLUSH(frame.snapshot.debugPrimitives);
+    OverdrawHeatmap::getOverdrawHeatmap().present();
 }
 
-bool AppState::isOpen() const
+void AppState::renderFrame()
 {
-    static SDL_Event e;
-    while(SDL_PollEvent(&e))
+    // a pipelined simulation would run frames behind the input it's given;
+    // on demand, the frame showing the input would stay in the pipeline
+    // until something else asks for a redraw
+    bool isSerial = EventQueue::getEventQueue().isRecordingOrReplaying() || m_renderMode == RenderMode::ON_DEMAND;
+    uint32 depth = isSerial ? 0 : m_requestedPipelineDepth;
+    if(depth != (m_framePipeline.isRunning() ? m_framePipeline.getDepth() : 0))
+    {
+        if(m_framePipeline.isRunning())
+            m_framePipeline.stop();
+        if(depth > 0)
+            m_framePipeline.start(depth, [this](FrameSnapshot& snapshot) { simulateFrame(snapshot); });
+    }
+
+    captureInput(m_frameInput);
+
+    if(m_framePipeline.isRunning())
     {
-        if(e.type == SDL_QUIT)
-            return false;
+        m_framePipeline.beginInput() = m_frameInput;
+        m_framePipeline.endInput();
+
+        // until the pipeline is full, the frames after it hold the input
+        // without its edges and time, so they add nothing to simulate
+        m_frameInput.frameSeconds = 0.0;
+        m_frameInput.inputState.beginFrame();
+        m_frameInput.actions.pressed = 0;
+        m_frameInput.actions.released = 0;
+        while(m_framePipeline.getFramesInFlight() < m_framePipeline.getDepth())
+        {
+            m_framePipeline.beginInput() = m_frameInput;
+            m_framePipeline.endInput();
+        }
+
+        submitFrame(m_framePipeline.beginSubmit());
+        m_framePipeline.endSubmit();
+        return;
     }
+
+    m_serialFrame.snapshot.input = m_frameInput;
+    m_serialFrame.snapshot.sprites.clear();
+    m_serialFrame.snapshot.lights.clear();
+    simulateFrame(m_serialFrame.snapshot);
+    FramePipeline::build(m_serialFrame);
+    submitFrame(m_serialFrame);
+}
+
+void AppState::onWindowResize(WindowResizeEvent& e)
+{
+    // snapshots pick the new size up for the camera, the dynamic resolution
+    // target and viewport follow it when the next frame begins
+    m_windowWidth = e.getWidth();
+    m_windowHeight = e.getHeight();
+    DAWN_DEBUG_DRAW_VIEWPORT(e.getWidth(), e.getHeight());
+    invalidate();
+}
+
+void AppState::onWindowMinimize(WindowMinimizeEvent& e)
+{
+    m_isMinimized = true;
+}
+
+void AppState::onWindowRestore(WindowRestoreEvent& e)
+{
+    m_isMinimized = false;
+    invalidate();
+}
+
+void AppState::onWindowFocusLost(WindowFocusLostEvent& e)
+{
+    // a second loss would save the throttled cap as the focused one
+    if(!m_isFocused)
+        return;
+
+    m_isFocused = false;
+    m_focusedFrameRateCap = m_framePacer.getFrameRateCap();
+
+    bool isCapLower = m_focusedFrameRateCap != 0 && m_focusedFrameRateCap <= m_unfocusedFrameRate;
+    if(m_unfocusedFrameRate != 0 && !isCapLower)
+        m_framePacer.setFrameRateCap(m_unfocusedFrameRate);
+}
+
+void AppState::onWindowFocusGained(WindowFocusGainedEvent& e)
+{
+    if(m_isFocused)
+        return;
+
+    m_isFocused = true;
+    m_framePacer.setFrameRateCap(m_focusedFrameRateCap);
+}
+
+void AppState::recordInput(const std::string& path)
+{
+    m_inputRecordingPath = path;
+    EventQueue::getEventQueue().startRecording();
+}
+
+bool AppState::replayInput(const std::string& path, bool isQuittingAfterReplay)
+{
+    if(!EventQueue::getEventQueue().startReplay(path))
+        return false;
+
+    m_isQuittingAfterReplay = isQuittingAfterReplay;
+    // every recorded frame has to be drained, idle frames included
+    m_renderMode = RenderMode::CONTINUOUS;
     return true;
 }
 
+void AppState::shutdownRenderer()
+{
+    EventQueue& eventQueue = EventQueue::getEventQueue();
+    if(eventQueue.isRecording())
+        eventQueue.stopRecording(m_inputRecordingPath);
+
+    if(m_framePipeline.isRunning())
+        m_framePipeline.stop();
+
+    m_lightCuller.shutdown();
+    m_dynamicResolution.shutdown();
+    TextureManager::getTextureManager().clear();
+}
+
 }
@@ -1,23 +1,110 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <string>
 #include "common.h"
+#include "input.h"
+#include "frame_pacer.h"
+#include "frame_timer.h"
+#include "fixed_timestep.h"
+#include "frame_pipeline.h"
+#include "timer_wheel.h"
+#include "action_map.h"
 #include "events/events.h"
+#include "events/event_queue.h"
+#include "events/event_bus.h"
+#include "graphics/dynamic_resolution.h"
+#include "graphics/light_culling.h"
 
 namespace Dawn
 {
+    enum class RenderMode
+    {
+        CONTINUOUS,
+        // only renders after input, invalidate() or while an animation runs
+        ON_DEMAND
+    };
+
     class AppState : public EventListener
     {
     public:
         static AppState* create();
         
-        AppState() { EventDispatcher::getEventDispatcher().addEventListener(this); }
-        virtual ~AppState() { EventDispatcher::getEventDispatcher().removeEventListener(this); };
+        AppState()
+        {
+            EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+            eventDispatcher.addEventListener(this, Event::MOUSE_BUTTON_DOWN);
+            eventDispatcher.addEventListener(this, Event::WINDOW_RESIZE);
+            eventDispatcher.addEventListener(this, Event::WINDOW_MINIMIZE);
+            eventDispatcher.addEventListener(this, Event::WINDOW_RESTORE);
+            eventDispatcher.addEventListener(this, Event::WINDOW_FOCUS_LOST);
+            eventDispatcher.addEventListener(this, Event::WINDOW_FOCUS_GAINED);
+            // an event posted while the loop sleeps is drained and may change what's on screen
+            EventQueue::getEventQueue().setWakeCallback([this]() { invalidate(); });
+            // so is a deferred bus event, its delivery needs a frame
+            EventBus::getEventBus().setWakeCallback([this]() { invalidate(); });
+        }
+        virtual ~AppState()
+        {
+            EventQueue::getEventQueue().setWakeCallback(nullptr);
+            EventBus::getEventBus().setWakeCallback(nullptr);
+            EventDispatcher::getEventDispatcher().removeEventListener(this);
+        }
 
         virtual void initWindow(const std::string& title, uint32 width, uint32 height) = 0;
         inline bool isRunning() const { return isAppRunning; }
         virtual uint32 getFps() const = 0;
         virtual void execute() = 0;
+        virtual void setVsyncMode(VsyncMode mode) = 0;
+        inline VsyncMode getVsyncMode() const { return m_vsyncMode; }
+
+        inline FramePacer& getFramePacer() { return m_framePacer; }
+        inline const FrameTimer& getFrameTimer() const { return m_frameTimer; }
+        inline FixedTimestep& getFixedTimestep() { return m_fixedTimestep; }
+
+        // Main thread timers in milliseconds of the loop's clock, fired once
+        // per loop iteration before the frame.
+        inline TimerWheel& getTimers() { return m_timers; }
+
+        // 0 runs simulation, command building and submission one after the
+        // other on the main thread, otherwise they overlap across up to depth
+        // frames. Applied at the start of the next frame, on-demand mode and
+        // input recording or replay always run serially.
+        inline void setPipelineDepth(uint32 depth) { m_requestedPipelineDepth = depth; }
+        inline FramePipeline& getFramePipeline() { return m_framePipeline; }
+
+        inline void setRenderMode(RenderMode mode) { m_renderMode = mode; }
+        inline RenderMode getRenderMode() const { return m_renderMode; }
+        // Longest the on-demand loop blocks waiting for events.
+        inline void setIdleTimeout(uint32 milliseconds) { m_idleTimeoutMs = milliseconds; }
+
+        // Requests a frame in on-demand mode, callable from any thread.
+        inline void invalidate() { m_isInvalidated = true; wakeUp(); }
+        // Keeps on-demand mode rendering continuously until every begun animation ended.
+        inline void beginAnimation() { m_activeAnimations++; wakeUp(); }
+        inline void endAnimation() { m_activeAnimations--; }
+
+        // Frame rate cap applied while the window has no focus, 0 doesn't throttle.
+        // Below step rate / max steps per frame the fixed timestep drops time
+        // every frame and the game runs slow in the background.
+        inline void setUnfocusedFrameRate(uint32 framesPerSecond) { m_unfocusedFrameRate = framesPerSecond; }
+        inline bool isMinimized() const { return m_isMinimized; }
+        inline bool isFocused() const { return m_isFocused; }
+
+        inline DynamicResolution& getDynamicResolution() { return m_dynamicResolution; }
+
+        // Resolved once per frame after the events are drained, bindings
+        // from actions.json when it exists.
+        inline ActionMap& getActionMap() { return m_actionMap; }
+
+        // Records the input of every frame, written to path when the app quits.
+        void recordInput(const std::string& path);
+        // Feeds a recording in place of the live input, frame by frame with
+        // the recorded frame times, so runs are repeatable across builds.
+        // The pipeline stays off meanwhile. Window events are part of the
+        // recording, the window should start at the recorded size.
+        bool replayInput(const std::string& path, bool isQuittingAfterReplay);
 
         void onMouseButtonDown(MouseButtonDownEvent& e)
         {
@@ -26,10 +113,69 @@ namespace Dawn
                 DAWN_INFO("Clicked at ({}, {})", e.posX, e.posY);
             }
         }
+
+        void onWindowResize(WindowResizeEvent& e) override;
+        void onWindowMinimize(WindowMinimizeEvent& e) override;
+        void onWindowRestore(WindowRestoreEvent& e) override;
+        void onWindowFocusLost(WindowFocusLostEvent& e) override;
+        void onWindowFocusGained(WindowFocusGainedEvent& e) override;
     protected:
         virtual void processEvents() = 0;
+        // Interrupts a blocking wait for events.
+        virtual void wakeUp() = 0;
+
+        inline bool isRedrawNeeded() const
+        {
+            // nothing is submitted while minimized, whatever the mode
+            return !m_isMinimized && (m_renderMode == RenderMode::CONTINUOUS || m_isInvalidated || m_activeAnimations > 0);
+        }
+
+        // Platform independent half of the frame, called by the platform
+        // layer once the GL context of the window is current.
+        void initRenderer(uint32 width, uint32 height);
+        void updateTimers();
+        void updateActions();
+        // Runs the simulation steps due and records what to draw, on the
+        // simulation thread while pipelined.
+        void simulateFrame(FrameSnapshot& snapshot);
+        void simulate(float stepSeconds, const FrameInput& input);
+        // Main thread, after the events are drained.
+        void captureInput(FrameInput& input);
+        // GL thread, draws a built frame.
+        void submitFrame(PipelineFrame& frame);
+        // Drives one frame through the pipeline or the serial path.
+        void renderFrame();
+        void shutdownRenderer();
 
         bool isAppRunning{};
+        uint32 m_windowWidth{};
+        uint32 m_windowHeight{};
+        bool m_isMinimized{};
+        bool m_isFocused{true};
+        // 4 steps a frame at the default 60 Hz, one short of the clamp so
+        // pacing jitter doesn't drop time
+        uint32 m_unfocusedFrameRate{15};
+        uint32 m_focusedFrameRateCap{};
+        DynamicResolution m_dynamicResolution{};
+        TiledLightCuller m_lightCuller{};
+        VsyncMode m_vsyncMode{VsyncMode::ON};
+        FramePacer m_framePacer{};
+        FrameTimer m_frameTimer{};
+        FixedTimestep m_fixedTimestep{};
+        FramePipeline m_framePipeline{};
+        PipelineFrame m_serialFrame{};
+        FrameInput m_frameInput{};
+        uint32 m_requestedPipelineDepth{};
+        TimerWheel m_timers{};
+        ActionMap m_actionMap{};
+        ActionId m_toggleDynamicResolution{ActionMap::INVALID_ACTION};
+        std::chrono::steady_clock::time_point m_clockStart{std::chrono::steady_clock::now()};
+        RenderMode m_renderMode{RenderMode::CONTINUOUS};
+        uint32 m_idleTimeoutMs{100};
+        std::atomic<bool> m_isInvalidated{true};
+        std::atomic<uint32> m_activeAnimations{};
+        std::string m_inputRecordingPath{};
+        bool m_isQuittingAfterReplay{};
     private:
         DAWN_NULL_COPY_AND_ASSIGN(AppState)
     };
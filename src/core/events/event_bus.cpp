@@ -0,0 +1,55 @@
+#include "event_bus.h"
+#include <atomic>
+
+namespace Dawn
+{
+    uint32 allocateEventTypeIndex()
+    {
+        static std::atomic<uint32> nextIndex{0};
+        return nextIndex++;
+    }
+
+    EventBus& EventBus::getEventBus()
+    {
+        static EventBus eventBus;
+        return eventBus;
+    }
+
+    bool EventBus::unsubscribe(EventBusHandle handle)
+    {
+        uint32 index = (uint32)(handle >> 32);
+        if(handle == INVALID_HANDLE || index >= m_channels.size() || !m_channels[index])
+            return false;
+
+        return m_channels[index]->unsubscribe((uint32)handle);
+    }
+
+    void EventBus::deliverDeferred()
+    {
+        m_stats.deferredDelivered = 0;
+        // a listener calling in here would deliver the same events twice
+        if(m_isDelivering || m_queuedOrder.empty())
+            return;
+
+        m_isDelivering = true;
+        m_deliveringOrder.swap(m_queuedOrder);
+        for(auto& channel : m_channels)
+        {
+            if(channel)
+                channel->beginDelivery();
+        }
+
+        for(uint32 index : m_deliveringOrder)
+            m_channels[index]->deliverNext();
+
+        for(auto& channel : m_channels)
+        {
+            if(channel)
+                channel->endDelivery();
+        }
+
+        m_stats.deferredDelivered = (uint32)m_deliveringOrder.size();
+        m_deliveringOrder.clear();
+        m_isDelivering = false;
+    }
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "core/common.h"
+
+namespace Dawn
+{
+	uint32 allocateEventTypeIndex();
+
+	// Dense index of the event struct, handed out on first use so buses can
+	// keep their channels in an array.
+	template <typename T>
+	inline uint32 getEventTypeIndex()
+	{
+		static const uint32 index = allocateEventTypeIndex();
+		return index;
+	}
+
+	// type index in the high half, subscription id in the low half, 0 is never issued
+	typedef uint64 EventBusHandle;
+
+	struct EventBusStats
+	{
+		uint32 channels{};
+		// during the last deliverDeferred()
+		uint32 deferredDelivered{};
+		// most events ever queued between two deliveries
+		uint32 deferredPeak{};
+	};
+
+	// Bus for event structs the game defines itself, next to the fixed
+	// Event::EventType set. Every struct gets its own channel: the typed
+	// callbacks subscribed to it and a pooled buffer for deferred events,
+	// which keeps its capacity from frame to frame. publish() delivers right
+	// away, enqueue() at the end of the frame in enqueue order across all
+	// types. Subscribing and unsubscribing are safe from inside a callback,
+	// changes to a channel apply once its outermost delivery returns.
+	// Main thread only.
+	class EventBus
+	{
+		class ChannelBase
+		{
+		public:
+			virtual ~ChannelBase() {}
+
+			virtual bool unsubscribe(uint32 id) = 0;
+			// Moves the queued events aside, events enqueued while they're
+			// delivered wait for the next frame.
+			virtual void beginDelivery() = 0;
+			virtual void deliverNext() = 0;
+			virtual void endDelivery() = 0;
+		};
+
+		template <typename T>
+		class Channel : public ChannelBase
+		{
+			struct Listener
+			{
+				uint32 id;
+				bool isAlive;
+				std::function<void(const T&)> callback;
+			};
+
+			// ids only grow, so both lists stay sorted by id
+			std::vector<Listener> m_listeners{};
+			std::vector<Listener> m_pending{};
+			uint32 m_nextId{1};
+			uint32 m_dispatchDepth{};
+			uint32 m_deadCount{};
+
+			std::vector<T> m_queued{};
+			std::vector<T> m_delivering{};
+			uint32 m_nextDelivery{};
+
+			void applyChanges()
+			{
+				if(m_deadCount > 0)
+				{
+					m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(), [](const Listener& listener){
+						return !listener.isAlive;
+					}), m_listeners.end());
+					m_deadCount = 0;
+				}
+
+				for(auto& listener : m_pending)
+				{
+					if(listener.isAlive)
+						m_listeners.push_back(std::move(listener));
+				}
+				m_pending.clear();
+			}
+
+			static bool kill(std::vector<Listener>& listeners, uint32 id)
+			{
+				auto it = std::lower_bound(listeners.begin(), listeners.end(), id, [](const Listener& listener, uint32 value){
+					return listener.id < value;
+				});
+				if(it == listeners.end() || it->id != id || !it->isAlive)
+					return false;
+
+				// the callback may be the one running, it's destroyed once the delivery is over
+				it->isAlive = false;
+				return true;
+			}
+
+		public:
+			uint32 subscribe(const std::function<void(const T&)>& callback)
+			{
+				uint32 id = m_nextId++;
+				// appending now could move the callbacks a delivery is running
+				std::vector<Listener>& list = m_dispatchDepth > 0 ? m_pending : m_listeners;
+				list.push_back({ id, true, callback });
+				return id;
+			}
+
+			bool unsubscribe(uint32 id) override
+			{
+				if(kill(m_listeners, id))
+				{
+					m_deadCount++;
+					if(m_dispatchDepth == 0)
+						applyChanges();
+					return true;
+				}
+
+				return kill(m_pending, id);
+			}
+
+			void publish(const T& event)
+			{
+				m_dispatchDepth++;
+				for(size_t i = 0; i < m_listeners.size(); i++)
+				{
+					if(m_listeners[i].isAlive)
+						m_listeners[i].callback(event);
+				}
+
+				if(--m_dispatchDepth == 0)
+					applyChanges();
+			}
+
+			inline void enqueue(const T& event) { m_queued.push_back(event); }
+
+			void beginDelivery() override
+			{
+				m_delivering.swap(m_queued);
+				m_nextDelivery = 0;
+			}
+
+			void deliverNext() override
+			{
+				publish(m_delivering[m_nextDelivery++]);
+			}
+
+			void endDelivery() override
+			{
+				m_delivering.clear();
+			}
+
+			inline uint32 getListenerCount() const { return (uint32)(m_listeners.size() - m_deadCount); }
+		};
+
+		// indexed by getEventTypeIndex(), null for types this bus never saw
+		std::vector<std::unique_ptr<ChannelBase>> m_channels{};
+		// type index of every deferred event, in enqueue order
+		std::vector<uint32> m_queuedOrder{};
+		std::vector<uint32> m_deliveringOrder{};
+		bool m_isDelivering{};
+		std::function<void()> m_wakeCallback{};
+
+		EventBusStats m_stats{};
+
+		template <typename T>
+		Channel<T>& getChannel()
+		{
+			uint32 index = getEventTypeIndex<T>();
+			if(index >= m_channels.size())
+				m_channels.resize(index + 1);
+
+			if(!m_channels[index])
+			{
+				m_channels[index].reset(new Channel<T>());
+				m_stats.channels++;
+			}
+
+			// the index is unique to T, so is the channel stored under it
+			return static_cast<Channel<T>&>(*m_channels[index]);
+		}
+
+		DAWN_NULL_COPY_AND_ASSIGN(EventBus)
+	public:
+		static const EventBusHandle INVALID_HANDLE = 0;
+
+		EventBus() {}
+		~EventBus() {}
+
+		static EventBus& getEventBus();
+
+		template <typename T>
+		EventBusHandle subscribe(const std::function<void(const T&)>& callback)
+		{
+			uint32 id = getChannel<T>().subscribe(callback);
+			return (uint64)getEventTypeIndex<T>() << 32 | id;
+		}
+
+		// False if the subscription is gone already.
+		bool unsubscribe(EventBusHandle handle);
+
+		// Delivers to every listener of T before returning.
+		template <typename T>
+		void publish(const T& event)
+		{
+			getChannel<T>().publish(event);
+		}
+
+		// Copies the event into T's buffer until deliverDeferred(), the first
+		// one since the last delivery runs the wake callback.
+		template <typename T>
+		void enqueue(const T& event)
+		{
+			getChannel<T>().enqueue(event);
+			m_queuedOrder.push_back(getEventTypeIndex<T>());
+			m_stats.deferredPeak = std::max(m_stats.deferredPeak, (uint32)m_queuedOrder.size());
+
+			if(m_queuedOrder.size() == 1 && m_wakeCallback)
+				m_wakeCallback();
+		}
+
+		// Gets a frame rendered for events enqueued outside of one, e.g. by a
+		// timer while the on-demand loop is idle, through AppState::invalidate().
+		inline void setWakeCallback(const std::function<void()>& callback) { m_wakeCallback = callback; }
+
+		// Once per frame, at its end.
+		void deliverDeferred();
+
+		template <typename T>
+		uint32 getListenerCount()
+		{
+			return getChannel<T>().getListenerCount();
+		}
+
+		inline uint32 getQueuedCount() const { return (uint32)m_queuedOrder.size(); }
+		inline const EventBusStats& getStats() const { return m_stats; }
+	};
+}
@@ -1,6 +1,7 @@
-#pragma once 
+#pragma once
 
 #include <string>
+#include <vector>
 #include <algorithm>
 #include <functional>
 #include "core/common.h"
@@ -9,25 +10,150 @@
 
 namespace Dawn
 {
+	// Delivers one event type to a listener.
+	typedef void (*EventShipFunction)(EventListener* eventListener, Event& e);
+	// Delivers a batch of one event type, events points at the first of count.
+	typedef void (*EventBatchShipFunction)(EventListener* eventListener, const Event* events, uint32 count);
+
+	// generation in the high half, slot index in the low half, 0 is never issued
+	typedef uint64 ListenerHandle;
+
+	// Each list is ordered by priority, highest first, and by subscription
+	// within a priority. A listener that calls Event::setHandled() ends the
+	// dispatch, so e.g. a UI layer subscribed above the game world can keep
+	// its clicks from reaching it.
+	//
+	// Listeners live in a slot map: a handle names a slot, and the slot's
+	// generation tells whether the subscription behind it still exists.
+	// Every list stays a dense array in dispatch order. Removing only
+	// bumps the slot's generation, so it's O(1) and safe from inside a
+	// callback; dispatch skips the dead entry and the list is compacted
+	// before its next dispatch. Subscriptions added during a dispatch are
+	// appended once the outermost dispatch returns.
 	class EventDispatcher
 	{
+		static const uint32 LIST_COUNT = 2 * Event::EVENT_TYPE_COUNT;
+		static const uint32 NIL = 0xffffffff;
+
+		struct Subscription
+		{
+			EventListener* listener;
+			ListenerHandle handle;
+			int32 priority;
+			EventShipFunction ship;
+			EventBatchShipFunction shipBatch;
+		};
+
+		struct Slot
+		{
+			uint32 generation{1};
+			// list the subscription is in, NIL while the slot is free
+			uint32 list{NIL};
+		};
+
+		struct PendingSubscription
+		{
+			uint32 list;
+			Subscription subscription;
+		};
+
 		EventDispatcher() {}
 		~EventDispatcher() {}
 
-		std::vector<EventListener*> eventListeners;
+		// per event type, the typed lists first, then the batch lists;
+		// dispatch only walks the interested listeners
+		std::vector<Subscription> subscriptions[LIST_COUNT];
+		uint32 staleCounts[LIST_COUNT]{};
+
+		std::vector<Slot> slots{};
+		std::vector<uint32> freeSlots{};
+		std::vector<PendingSubscription> pendingSubscriptions{};
+		uint32 dispatchDepth{};
+
+		inline bool isAlive(ListenerHandle handle) const
+		{
+			return slots[(uint32)handle].generation == (uint32)(handle >> 32);
+		}
+
+		ListenerHandle subscribe(uint32 list, EventListener* eventListener, int32 priority,
+		                         EventShipFunction ship, EventBatchShipFunction shipBatch);
+		void insert(uint32 list, const Subscription& subscription);
+		void release(uint32 slot);
+		// before the first dispatch of the list that follows a removal
+		void compact(uint32 list);
+		void beginDispatch(uint32 list);
+		void endDispatch();
+		void removeFromList(EventListener* eventListener, uint32 list);
 	public:
+		static const ListenerHandle INVALID_HANDLE = 0;
+
 		static EventDispatcher& getEventDispatcher();
 
 		template <typename T>
 		void dispatchEvent(T& event)
 		{
-			for(auto e : eventListeners)
+			uint32 list = event.getEventType();
+			event.handled = false;
+			beginDispatch(list);
+
+			// nothing is added to or erased from the list until endDispatch(),
+			// while nothing in it was removed every entry is alive
+			std::vector<Subscription>& listeners = subscriptions[list];
+			for(size_t i = 0; i < listeners.size(); i++)
 			{
-				e->shipEvent(event);
+				Subscription& subscription = listeners[i];
+				if(staleCounts[list] == 0 || isAlive(subscription.handle))
+				{
+					subscription.ship(subscription.listener, event);
+					if(event.handled)
+						break;
+				}
 			}
+
+			endDispatch();
 		}
 
-		void addEventListener(EventListener* eventListener);
+		template <typename T>
+		void dispatchBatch(const std::vector<T>& events)
+		{
+			if(events.empty())
+				return;
+
+			uint32 list = Event::EVENT_TYPE_COUNT + events[0].getEventType();
+			beginDispatch(list);
+
+			std::vector<Subscription>& listeners = subscriptions[list];
+			for(size_t i = 0; i < listeners.size(); i++)
+			{
+				Subscription& subscription = listeners[i];
+				if(staleCounts[list] == 0 || isAlive(subscription.handle))
+					subscription.shipBatch(subscription.listener, events.data(), (uint32)events.size());
+			}
+
+			endDispatch();
+		}
+
+		inline bool hasBatchListeners(Event::EventType eventType) const
+		{
+			return subscriptions[Event::EVENT_TYPE_COUNT + eventType].size() > staleCounts[Event::EVENT_TYPE_COUNT + eventType];
+		}
+
+		// Subscribes to every event type but RAW_MOUSE_MOVE through shipEvent(), onEvent() included.
+		void addEventListener(EventListener* eventListener, int32 priority = 0);
+		// Subscribes to a single type, calling only its typed handler.
+		ListenerHandle addEventListener(EventListener* eventListener, Event::EventType eventType, int32 priority = 0);
+		// Subscribes to the type's batched handler instead, called once per
+		// frame after the drain with the frame's events in order, minus the
+		// ones a listener handled. Batches of different types arrive in
+		// EventType order, not interleaved.
+		ListenerHandle addBatchListener(EventListener* eventListener, Event::EventType eventType, int32 priority = 0);
+
+		// O(1), false if the subscription is gone already.
+		bool removeEventListener(ListenerHandle handle);
+		// Removes every subscription of the listener, batched ones included.
+		// These walk the lists looking for the listener.
 		void removeEventListener(EventListener* eventListener);
+		void removeEventListener(EventListener* eventListener, Event::EventType eventType);
+		void removeBatchListener(EventListener* eventListener, Event::EventType eventType);
 	};
 }
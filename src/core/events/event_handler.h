@@ -10,9 +10,37 @@ namespace Dawn
 	class EventHandler
 	{
 	private:
+		template <typename T>
+		struct EventBatch
+		{
+			std::vector<T> events;
+			// the list handed out, swapped with events while it's delivered
+			std::vector<T> delivering;
+		};
+
 		EventHandler() {}
 		~EventHandler() {}
 
+		// the frame's events per type, only collected while the type has batch listeners
+		EventBatch<KeyDownEvent> m_keyDownEvents{};
+		EventBatch<KeyUpEvent> m_keyUpEvents{};
+		EventBatch<MouseButtonDownEvent> m_mouseButtonDownEvents{};
+		EventBatch<MouseButtonUpEvent> m_mouseButtonUpEvents{};
+		EventBatch<MouseMoveEvent> m_mouseMoveEvents{};
+		EventBatch<RawMouseMoveEvent> m_rawMouseMoveEvents{};
+		EventBatch<MouseWheelEvent> m_mouseWheelEvents{};
+		EventBatch<WindowResizeEvent> m_windowResizeEvents{};
+		EventBatch<WindowMinimizeEvent> m_windowMinimizeEvents{};
+		EventBatch<WindowRestoreEvent> m_windowRestoreEvents{};
+		EventBatch<WindowFocusLostEvent> m_windowFocusLostEvents{};
+		EventBatch<WindowFocusGainedEvent> m_windowFocusGainedEvents{};
+
+		// dispatches to the per-event listeners and collects for the batched ones
+		template <typename T>
+		void deliver(T& event, EventBatch<T>& batch);
+		template <typename T>
+		void flush(EventBatch<T>& batch);
+
 		DAWN_NULL_COPY_AND_ASSIGN(EventHandler)
 	public:
 		void onKeyDown(uint32 keyCode, bool isRepeat);
@@ -21,6 +49,17 @@ namespace Dawn
 	    void onMouseButtonUp(uint32 mouseButton, uint8 numClicks, int32 posX, int32 posY);
 	    void onMouseMove(int32 mousePosX, int32 mousePosY, 
 	    	                     int32 deltaX, int32 deltaY);
+	    void onRawMouseMove(int32 mousePosX, int32 mousePosY, int32 deltaX, int32 deltaY);
+	    void onMouseWheel(int32 wheelX, int32 wheelY);
+	    void onWindowResize(uint32 width, uint32 height);
+	    void onWindowMinimize();
+	    void onWindowRestore();
+	    void onWindowFocusLost();
+	    void onWindowFocusGained();
+
+	    // Hands the collected events to the batch listeners, once per frame
+	    // after the drain.
+	    void deliverBatches();
 
 		static EventHandler* getEventHandler();
 	};
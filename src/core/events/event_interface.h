@@ -14,11 +14,39 @@ namespace Dawn
 			KEY_UP,
 			MOUSE_BUTTON_DOWN,
 			MOUSE_BUTTON_UP,
-			MOUSE_MOVE
+			MOUSE_MOVE,
+			// every motion event as polled, only for listeners subscribing to it
+			RAW_MOUSE_MOVE,
+			MOUSE_WHEEL,
+			WINDOW_RESIZE,
+			WINDOW_MINIMIZE,
+			WINDOW_RESTORE,
+			WINDOW_FOCUS_LOST,
+			WINDOW_FOCUS_GAINED,
+
+			EVENT_TYPE_COUNT
 		};
 
 		inline const EventType& getEventType() const { return eventType; }
 
+		// Consumes the event, listeners of lower priority don't get to see it.
+		inline void setHandled() { handled = true; }
+		inline bool isHandled() const { return handled; }
+
 		EventType eventType{};
+		bool handled{};
+	};
+
+	// Contiguous run of events of one type, valid for the duration of the call it's passed to.
+	template <typename T>
+	struct EventSpan
+	{
+		const T* events;
+		unsigned int count;
+
+		inline const T* begin() const { return events; }
+		inline const T* end() const { return events + count; }
+		inline unsigned int size() const { return count; }
+		inline const T& operator[](unsigned int index) const { return events[index]; }
 	};
 }
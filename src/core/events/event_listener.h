@@ -20,5 +20,27 @@ namespace Dawn
 		virtual void onMouseButtonDown(MouseButtonDownEvent& mouseDownEvent) {}
 		virtual void onMouseButtonUp(MouseButtonUpEvent& mouseButtonUp) {}
 		virtual void onMouseMove(MouseMoveEvent& mouseMoveEvent) {}
+		virtual void onRawMouseMove(RawMouseMoveEvent& rawMouseMoveEvent) {}
+		virtual void onMouseWheel(MouseWheelEvent& mouseWheelEvent) {}
+		virtual void onWindowResize(WindowResizeEvent& windowResizeEvent) {}
+		virtual void onWindowMinimize(WindowMinimizeEvent& windowMinimizeEvent) {}
+		virtual void onWindowRestore(WindowRestoreEvent& windowRestoreEvent) {}
+		virtual void onWindowFocusLost(WindowFocusLostEvent& windowFocusLostEvent) {}
+		virtual void onWindowFocusGained(WindowFocusGainedEvent& windowFocusGainedEvent) {}
+
+		// Batched delivery, every event of the type the frame produced in one
+		// call. Only for types subscribed with EventDispatcher::addBatchListener().
+		virtual void onKeyDownBatch(EventSpan<KeyDownEvent> events) {}
+		virtual void onKeyUpBatch(EventSpan<KeyUpEvent> events) {}
+		virtual void onMouseButtonDownBatch(EventSpan<MouseButtonDownEvent> events) {}
+		virtual void onMouseButtonUpBatch(EventSpan<MouseButtonUpEvent> events) {}
+		virtual void onMouseMoveBatch(EventSpan<MouseMoveEvent> events) {}
+		virtual void onRawMouseMoveBatch(EventSpan<RawMouseMoveEvent> events) {}
+		virtual void onMouseWheelBatch(EventSpan<MouseWheelEvent> events) {}
+		virtual void onWindowResizeBatch(EventSpan<WindowResizeEvent> events) {}
+		virtual void onWindowMinimizeBatch(EventSpan<WindowMinimizeEvent> events) {}
+		virtual void onWindowRestoreBatch(EventSpan<WindowRestoreEvent> events) {}
+		virtual void onWindowFocusLostBatch(EventSpan<WindowFocusLostEvent> events) {}
+		virtual void onWindowFocusGainedBatch(EventSpan<WindowFocusGainedEvent> events) {}
 	};
 }
@@ -0,0 +1,216 @@
+#include "event_queue.h"
+#include "event_handler.h"
+#include "core/input_state.h"
+
+namespace Dawn
+{
+    EventQueue& EventQueue::getEventQueue()
+    {
+        static EventQueue eventQueue;
+        return eventQueue;
+    }
+
+    void EventQueue::push(const QueuedEvent& event)
+    {
+        if(m_platformEvents.push(event))
+            m_stats.platformPushed++;
+        else
+            m_stats.platformDropped++;
+    }
+
+    void EventQueue::post(const QueuedEvent& event)
+    {
+        if(!m_postedEvents.push(event))
+        {
+            m_postDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        m_posted.fetch_add(1, std::memory_order_relaxed);
+        if(m_wakeCallback)
+            m_wakeCallback();
+    }
+
+    void EventQueue::drain()
+    {
+        m_stats.drained = 0;
+        m_stats.rawMouseMoves = 0;
+        m_stats.dispatchedMouseMoves = 0;
+        InputState::getInputState().beginFrame();
+        QueuedEvent event;
+
+        uint32 platformCount = m_platformEvents.size();
+        m_inputFrameSeconds = 0.0;
+        if(m_player.isPlaying())
+        {
+            // the live input would disturb the replay
+            for(uint32 i = 0; i < platformCount && m_platformEvents.pop(event); i++) {}
+
+            uint32 count = 0;
+            const QueuedEvent* events = m_player.getFrameEvents(count);
+            for(uint32 i = 0; i < count; i++)
+                dispatch(events[i]);
+
+            m_stats.drained += count;
+            m_inputFrameSeconds = m_player.getFrameSeconds();
+            m_player.endFrame();
+        }
+        else
+        {
+            for(uint32 i = 0; i < platformCount && m_platformEvents.pop(event); i++)
+            {
+                if(m_recorder.isRecording())
+                    m_recorder.record(event);
+
+                dispatch(event);
+                m_stats.drained++;
+            }
+
+            if(m_recorder.isRecording())
+                m_inputFrameSeconds = m_recorder.endFrame();
+        }
+        flushPendingMouseMove();
+
+        for(uint32 i = 0; i < m_postedEvents.capacity() && m_postedEvents.pop(event); i++)
+        {
+            dispatch(event);
+            m_stats.drained++;
+        }
+        flushPendingMouseMove();
+
+        EventHandler::getEventHandler()->deliverBatches();
+    }
+
+    void EventQueue::dispatchMouseMove(const MouseMoveEventData& mouseMove)
+    {
+        EventHandler* eventHandler = EventHandler::getEventHandler();
+        eventHandler->onRawMouseMove(mouseMove.posX, mouseMove.posY, mouseMove.deltaX, mouseMove.deltaY);
+        m_stats.rawMouseMoves++;
+
+        if(!m_isCoalescingMouseMotion)
+        {
+            eventHandler->onMouseMove(mouseMove.posX, mouseMove.posY, mouseMove.deltaX, mouseMove.deltaY);
+            m_stats.dispatchedMouseMoves++;
+            return;
+        }
+
+        if(!m_hasPendingMouseMove)
+        {
+            m_pendingMouseMove = mouseMove;
+            m_hasPendingMouseMove = true;
+            return;
+        }
+
+        m_pendingMouseMove.posX = mouseMove.posX;
+        m_pendingMouseMove.posY = mouseMove.posY;
+        m_pendingMouseMove.deltaX += mouseMove.deltaX;
+        m_pendingMouseMove.deltaY += mouseMove.deltaY;
+    }
+
+    void EventQueue::flushPendingMouseMove()
+    {
+        if(!m_hasPendingMouseMove)
+            return;
+
+        m_hasPendingMouseMove = false;
+        EventHandler::getEventHandler()->onMouseMove(m_pendingMouseMove.posX, m_pendingMouseMove.posY,
+                                                     m_pendingMouseMove.deltaX, m_pendingMouseMove.deltaY);
+        m_stats.dispatchedMouseMoves++;
+    }
+
+    void EventQueue::updateInputState(const QueuedEvent& event)
+    {
+        InputState& inputState = InputState::getInputState();
+
+        switch(event.type)
+        {
+            case Event::KEY_DOWN:
+                inputState.onKeyDown(event.key.keyCode, event.key.isRepeat);
+                    break;
+            case Event::KEY_UP:
+                inputState.onKeyUp(event.key.keyCode);
+                    break;
+            case Event::MOUSE_BUTTON_DOWN:
+                inputState.onMouseButtonDown(event.mouseButton.mouseButton, event.mouseButton.posX, event.mouseButton.posY);
+                    break;
+            case Event::MOUSE_BUTTON_UP:
+                inputState.onMouseButtonUp(event.mouseButton.mouseButton, event.mouseButton.posX, event.mouseButton.posY);
+                    break;
+            case Event::MOUSE_MOVE:
+                inputState.onMouseMove(event.mouseMove.posX, event.mouseMove.posY,
+                                       event.mouseMove.deltaX, event.mouseMove.deltaY);
+                    break;
+            case Event::MOUSE_WHEEL:
+                inputState.onMouseWheel(event.mouseWheel.wheelX, event.mouseWheel.wheelY);
+                    break;
+            case Event::WINDOW_FOCUS_LOST:
+                inputState.releaseAll();
+                    break;
+            default:
+                break;
+        }
+    }
+
+    void EventQueue::dispatch(const QueuedEvent& event)
+    {
+        // listeners already see the state including their own event
+        updateInputState(event);
+
+        if(event.type == Event::MOUSE_MOVE)
+        {
+            dispatchMouseMove(event.mouseMove);
+            return;
+        }
+
+        // anything else ends the run, a click has to see the motion before it
+        flushPendingMouseMove();
+
+        EventHandler* eventHandler = EventHandler::getEventHandler();
+
+        switch(event.type)
+        {
+            case Event::KEY_DOWN:
+                eventHandler->onKeyDown(event.key.keyCode, event.key.isRepeat);
+                    break;
+            case Event::KEY_UP:
+                eventHandler->onKeyUp(event.key.keyCode, event.key.isRepeat);
+                    break;
+            case Event::MOUSE_BUTTON_DOWN:
+                eventHandler->onMouseButtonDown(event.mouseButton.mouseButton, event.mouseButton.numClicks,
+                                                event.mouseButton.posX, event.mouseButton.posY);
+                    break;
+            case Event::MOUSE_BUTTON_UP:
+                eventHandler->onMouseButtonUp(event.mouseButton.mouseButton, event.mouseButton.numClicks,
+                                              event.mouseButton.posX, event.mouseButton.posY);
+                    break;
+            case Event::MOUSE_WHEEL:
+                eventHandler->onMouseWheel(event.mouseWheel.wheelX, event.mouseWheel.wheelY);
+                    break;
+            case Event::WINDOW_RESIZE:
+                eventHandler->onWindowResize(event.window.width, event.window.height);
+                    break;
+            case Event::WINDOW_MINIMIZE:
+                eventHandler->onWindowMinimize();
+                    break;
+            case Event::WINDOW_RESTORE:
+                eventHandler->onWindowRestore();
+                    break;
+            case Event::WINDOW_FOCUS_LOST:
+                eventHandler->onWindowFocusLost();
+                    break;
+            case Event::WINDOW_FOCUS_GAINED:
+                eventHandler->onWindowFocusGained();
+                    break;
+            default:
+                break;
+        }
+    }
+
+    EventQueueStats EventQueue::getStats() const
+    {
+        EventQueueStats stats = m_stats;
+        stats.posted = m_posted.load(std::memory_order_relaxed);
+        stats.postDropped = m_postDropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "core/common.h"
+#include "event_interface.h"
+#include "queued_event.h"
+#include "input_recording.h"
+
+namespace Dawn
+{
+	// Bounded single producer / single consumer ring. Each side keeps a cached
+	// copy of the other side's index and only reloads it when the ring looks
+	// full or empty, so the indices rarely bounce between cores.
+	template <typename T>
+	class SpscQueue
+	{
+		std::vector<T> m_items;
+		uint32 m_mask;
+
+		alignas(64) std::atomic<uint32> m_head{};
+		uint32 m_cachedTail{};
+
+		alignas(64) std::atomic<uint32> m_tail{};
+		uint32 m_cachedHead{};
+
+		DAWN_NULL_COPY_AND_ASSIGN(SpscQueue)
+	public:
+		// capacity has to be a power of two
+		explicit SpscQueue(uint32 capacity) : m_items(capacity), m_mask(capacity - 1) {}
+
+		// Producer side, false when full.
+		bool push(const T& item)
+		{
+			uint32 tail = m_tail.load(std::memory_order_relaxed);
+			if(tail - m_cachedHead > m_mask)
+			{
+				m_cachedHead = m_head.load(std::memory_order_acquire);
+				if(tail - m_cachedHead > m_mask)
+					return false;
+			}
+
+			m_items[tail & m_mask] = item;
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer side, false when empty.
+		bool pop(T& item)
+		{
+			uint32 head = m_head.load(std::memory_order_relaxed);
+			if(head == m_cachedTail)
+			{
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+				if(head == m_cachedTail)
+					return false;
+			}
+
+			item = m_items[head & m_mask];
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Consumer side, items pushed after the call aren't counted.
+		inline uint32 size() const { return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_relaxed); }
+		inline uint32 capacity() const { return m_mask + 1; }
+	};
+
+	// Bounded multi producer / single consumer ring. Every cell carries a
+	// sequence number telling producers and the consumer whose turn it is,
+	// producers only contend on one compare-exchange of the tail.
+	template <typename T>
+	class MpscQueue
+	{
+		struct Cell
+		{
+			std::atomic<uint32> sequence;
+			T item;
+		};
+
+		std::vector<Cell> m_cells;
+		uint32 m_mask;
+
+		alignas(64) std::atomic<uint32> m_tail{};
+		alignas(64) uint32 m_head{};
+
+		DAWN_NULL_COPY_AND_ASSIGN(MpscQueue)
+	public:
+		// capacity has to be a power of two
+		explicit MpscQueue(uint32 capacity) : m_cells(capacity), m_mask(capacity - 1)
+		{
+			for(uint32 i = 0; i < capacity; i++)
+				m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		// Any thread, false when full.
+		bool push(const T& item)
+		{
+			uint32 tail = m_tail.load(std::memory_order_relaxed);
+			while(true)
+			{
+				Cell& cell = m_cells[tail & m_mask];
+				int32 difference = (int32)(cell.sequence.load(std::memory_order_acquire) - tail);
+
+				if(difference == 0)
+				{
+					if(m_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+					{
+						cell.item = item;
+						cell.sequence.store(tail + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if(difference < 0)
+				{
+					return false;
+				}
+				else
+				{
+					tail = m_tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// Consumer thread only, false when empty.
+		bool pop(T& item)
+		{
+			Cell& cell = m_cells[m_head & m_mask];
+			if(cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+				return false;
+
+			item = cell.item;
+			cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+			m_head++;
+			return true;
+		}
+
+		inline uint32 capacity() const { return m_mask + 1; }
+	};
+
+	struct EventQueueStats
+	{
+		uint32 platformPushed{};
+		uint32 platformDropped{};
+		uint32 posted{};
+		uint32 postDropped{};
+		// during the last drain()
+		uint32 drained{};
+		// motion events polled vs MOUSE_MOVE events dispatched for them
+		uint32 rawMouseMoves{};
+		uint32 dispatchedMouseMoves{};
+	};
+
+	// Decouples producing events from dispatching them. The platform layer
+	// pushes what it polls into an SPSC ring, worker threads post into an
+	// MPSC ring, and the main loop drains both at one point in the frame.
+	// A full queue drops the event rather than blocking its producer.
+	class EventQueue
+	{
+		static const uint32 PLATFORM_CAPACITY = 4096;
+		static const uint32 POST_CAPACITY = 1024;
+
+		EventQueue() {}
+		~EventQueue() {}
+
+		SpscQueue<QueuedEvent> m_platformEvents{PLATFORM_CAPACITY};
+		MpscQueue<QueuedEvent> m_postedEvents{POST_CAPACITY};
+
+		std::function<void()> m_wakeCallback{};
+		std::atomic<uint32> m_posted{};
+		std::atomic<uint32> m_postDropped{};
+		EventQueueStats m_stats{};
+
+		bool m_isCoalescingMouseMotion{true};
+		bool m_hasPendingMouseMove{};
+		MouseMoveEventData m_pendingMouseMove{};
+
+		InputRecorder m_recorder{};
+		InputPlayer m_player{};
+		double m_inputFrameSeconds{};
+
+		void updateInputState(const QueuedEvent& event);
+		void dispatch(const QueuedEvent& event);
+		void dispatchMouseMove(const MouseMoveEventData& mouseMove);
+		void flushPendingMouseMove();
+
+		DAWN_NULL_COPY_AND_ASSIGN(EventQueue)
+	public:
+		static EventQueue& getEventQueue();
+
+		// Polling thread only.
+		void push(const QueuedEvent& event);
+		// Any thread, runs the wake callback once the event is queued.
+		void post(const QueuedEvent& event);
+		// Lets post() get a sleeping main loop to drain, e.g. through
+		// AppState::invalidate(). Set before any thread posts.
+		inline void setWakeCallback(const std::function<void()>& callback) { m_wakeCallback = callback; }
+
+		// Dispatches platform events first, then posted ones, through the
+		// EventHandler, and brings the InputState up to date. At most what
+		// was queued on entry is dispatched, plus one ring's worth of posts,
+		// so producers can't stall the frame.
+		void drain();
+
+		// Collapses each run of consecutive motion events into one MOUSE_MOVE
+		// with the summed delta and the latest position. RAW_MOUSE_MOVE still
+		// goes out once per motion event either way.
+		inline void setMouseMotionCoalescing(bool isEnabled) { m_isCoalescingMouseMotion = isEnabled; }
+		inline bool isCoalescingMouseMotion() const { return m_isCoalescingMouseMotion; }
+
+		// Records the platform events each drain() dispatches, per frame.
+		inline void startRecording() { m_recorder.start(); }
+		inline bool stopRecording(const std::string& path) { return m_recorder.stop(path); }
+		inline bool isRecording() const { return m_recorder.isRecording(); }
+
+		// Each drain() dispatches the next recorded frame instead of the
+		// polled events, which are dropped, until the recording runs out.
+		// Posted events still go through.
+		inline bool startReplay(const std::string& path) { return m_player.start(path); }
+		inline void stopReplay() { m_player.stop(); }
+		inline bool isReplaying() const { return m_player.isPlaying(); }
+		// Length of the frame the last drain() recorded or replayed, 0 if
+		// neither. Simulating with it makes the replay step like the recording.
+		inline double getInputFrameSeconds() const { return m_inputFrameSeconds; }
+		inline bool isRecordingOrReplaying() const { return m_recorder.isRecording() || m_player.isPlaying(); }
+
+		EventQueueStats getStats() const;
+	};
+}
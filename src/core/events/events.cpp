@@ -3,80 +3,213 @@
 
 namespace Dawn
 {
+    template <typename T>
+    void EventHandler::deliver(T& event, EventBatch<T>& batch)
+    {
+        EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+        eventDispatcher.dispatchEvent(event);
+
+        // a consumed event is gone for the batch listeners too
+        if(!event.isHandled() && eventDispatcher.hasBatchListeners(event.getEventType()))
+            batch.events.push_back(event);
+    }
+
+    template <typename T>
+    void EventHandler::flush(EventBatch<T>& batch)
+    {
+        // events raised by a batch handler land in the emptied list, for the next frame
+        batch.delivering.swap(batch.events);
+        EventDispatcher::getEventDispatcher().dispatchBatch(batch.delivering);
+        batch.delivering.clear();
+    }
+
     void EventHandler::onKeyDown(uint32 keyCode, bool isRepeat)
     {
-    	static KeyDownEvent keyDownEvent;
-    	keyDownEvent.keyCode = keyCode;
-    	keyDownEvent.isRepeat = isRepeat;
+        KeyDownEvent keyDownEvent;
+        keyDownEvent.keyCode = keyCode;
+        keyDownEvent.isRepeat = isRepeat;
 
-    	EventDispatcher::getEventDispatcher().dispatchEvent(keyDownEvent);
+        deliver(keyDownEvent, m_keyDownEvents);
     }
 
     void EventHandler::onKeyUp(uint32 keyCode, bool isRepeat)
     {
-    	static KeyUpEvent keyUpEvent;
-    	keyUpEvent.keyCode = keyCode;
-    	keyUpEvent.isRepeat = isRepeat;
+        KeyUpEvent keyUpEvent;
+        keyUpEvent.keyCode = keyCode;
+        keyUpEvent.isRepeat = isRepeat;
 
-    	EventDispatcher::getEventDispatcher().dispatchEvent(keyUpEvent);
+        deliver(keyUpEvent, m_keyUpEvents);
     }
 
     void EventHandler::onMouseButtonDown(uint32 mouseButton, uint8 numClicks, int32 posX, int32 posY)
     {
-    	static MouseButtonDownEvent mouseButtonDownEvent;
-    	mouseButtonDownEvent.mouseButtonCode = mouseButton;
-    	mouseButtonDownEvent.numClicks = numClicks;
+        MouseButtonDownEvent mouseButtonDownEvent;
+        mouseButtonDownEvent.mouseButtonCode = mouseButton;
+        mouseButtonDownEvent.numClicks = numClicks;
         mouseButtonDownEvent.posX = posX;
         mouseButtonDownEvent.posY = posY;
 
-    	EventDispatcher::getEventDispatcher().dispatchEvent(mouseButtonDownEvent);
+        deliver(mouseButtonDownEvent, m_mouseButtonDownEvents);
     }
 
     void EventHandler::onMouseButtonUp(uint32 mouseButton, uint8 numClicks, int32 posX, int32 posY)
     {
-    	static MouseButtonUpEvent mouseButtonUpEvent;
-    	mouseButtonUpEvent.mouseButtonCode = mouseButton;
-    	mouseButtonUpEvent.numClicks = numClicks;
+        MouseButtonUpEvent mouseButtonUpEvent;
+        mouseButtonUpEvent.mouseButtonCode = mouseButton;
+        mouseButtonUpEvent.numClicks = numClicks;
         mouseButtonUpEvent.posX = posX;
         mouseButtonUpEvent.posY = posY;
 
-    	EventDispatcher::getEventDispatcher().dispatchEvent(mouseButtonUpEvent);
+        deliver(mouseButtonUpEvent, m_mouseButtonUpEvents);
     }
 
     void EventHandler::onMouseMove(int32 mousePosX, int32 mousePosY, 
 	    	                     int32 deltaX, int32 deltaY)
     {
-    	static MouseMoveEvent mouseMoveEvent;
-    	mouseMoveEvent.posX = mousePosX;
-    	mouseMoveEvent.posY = mousePosY;
+        MouseMoveEvent mouseMoveEvent;
+        mouseMoveEvent.posX = mousePosX;
+        mouseMoveEvent.posY = mousePosY;
 
-    	mouseMoveEvent.deltaX = deltaX;
-    	mouseMoveEvent.deltaY = deltaY;
+        mouseMoveEvent.deltaX = deltaX;
+        mouseMoveEvent.deltaY = deltaY;
 
-    	EventDispatcher::getEventDispatcher().dispatchEvent(mouseMoveEvent);
+        deliver(mouseMoveEvent, m_mouseMoveEvents);
+    }
+
+    void EventHandler::onRawMouseMove(int32 mousePosX, int32 mousePosY, int32 deltaX, int32 deltaY)
+    {
+        RawMouseMoveEvent rawMouseMoveEvent;
+        rawMouseMoveEvent.posX = mousePosX;
+        rawMouseMoveEvent.posY = mousePosY;
+
+        rawMouseMoveEvent.deltaX = deltaX;
+        rawMouseMoveEvent.deltaY = deltaY;
+
+        deliver(rawMouseMoveEvent, m_rawMouseMoveEvents);
+    }
+
+    void EventHandler::onMouseWheel(int32 wheelX, int32 wheelY)
+    {
+        MouseWheelEvent mouseWheelEvent;
+        mouseWheelEvent.wheelX = wheelX;
+        mouseWheelEvent.wheelY = wheelY;
+
+        deliver(mouseWheelEvent, m_mouseWheelEvents);
+    }
+
+    void EventHandler::onWindowResize(uint32 width, uint32 height)
+    {
+        WindowResizeEvent windowResizeEvent;
+        windowResizeEvent.width = width;
+        windowResizeEvent.height = height;
+
+        deliver(windowResizeEvent, m_windowResizeEvents);
+    }
+
+    void EventHandler::onWindowMinimize()
+    {
+        WindowMinimizeEvent windowMinimizeEvent;
+        deliver(windowMinimizeEvent, m_windowMinimizeEvents);
+    }
+
+    void EventHandler::onWindowRestore()
+    {
+        WindowRestoreEvent windowRestoreEvent;
+        deliver(windowRestoreEvent, m_windowRestoreEvents);
+    }
+
+    void EventHandler::onWindowFocusLost()
+    {
+        WindowFocusLostEvent windowFocusLostEvent;
+        deliver(windowFocusLostEvent, m_windowFocusLostEvents);
+    }
+
+    void EventHandler::onWindowFocusGained()
+    {
+        WindowFocusGainedEvent windowFocusGainedEvent;
+        deliver(windowFocusGainedEvent, m_windowFocusGainedEvents);
+    }
+
+    void EventHandler::deliverBatches()
+    {
+        flush(m_keyDownEvents);
+        flush(m_keyUpEvents);
+        flush(m_mouseButtonDownEvents);
+        flush(m_mouseButtonUpEvents);
+        flush(m_mouseMoveEvents);
+        flush(m_rawMouseMoveEvents);
+        flush(m_mouseWheelEvents);
+        flush(m_windowResizeEvents);
+        flush(m_windowMinimizeEvents);
+        flush(m_windowRestoreEvents);
+        flush(m_windowFocusLostEvents);
+        flush(m_windowFocusGainedEvents);
+    }
+
+    namespace
+    {
+        template <typename T, void (EventListener::*handler)(T&)>
+        void shipTyped(EventListener* eventListener, Event& e)
+        {
+            (eventListener->*handler)((T&)e);
+        }
+
+        template <typename T, void (EventListener::*handler)(EventSpan<T>)>
+        void shipBatch(EventListener* eventListener, const Event* events, uint32 count)
+        {
+            EventSpan<T> span = { static_cast<const T*>(events), count };
+            (eventListener->*handler)(span);
+        }
+
+        void shipAll(EventListener* eventListener, Event& e)
+        {
+            eventListener->shipEvent(e);
+        }
+
+        // indexed by Event::EventType
+        const EventShipFunction typedShipFunctions[Event::EVENT_TYPE_COUNT] =
+        {
+            nullptr,
+            shipTyped<KeyDownEvent, &EventListener::onKeyDown>,
+            shipTyped<KeyUpEvent, &EventListener::onKeyUp>,
+            shipTyped<MouseButtonDownEvent, &EventListener::onMouseButtonDown>,
+            shipTyped<MouseButtonUpEvent, &EventListener::onMouseButtonUp>,
+            shipTyped<MouseMoveEvent, &EventListener::onMouseMove>,
+            shipTyped<RawMouseMoveEvent, &EventListener::onRawMouseMove>,
+            shipTyped<MouseWheelEvent, &EventListener::onMouseWheel>,
+            shipTyped<WindowResizeEvent, &EventListener::onWindowResize>,
+            shipTyped<WindowMinimizeEvent, &EventListener::onWindowMinimize>,
+            shipTyped<WindowRestoreEvent, &EventListener::onWindowRestore>,
+            shipTyped<WindowFocusLostEvent, &EventListener::onWindowFocusLost>,
+            shipTyped<WindowFocusGainedEvent, &EventListener::onWindowFocusGained>
+        };
+
+        // indexed by Event::EventType
+        const EventBatchShipFunction batchShipFunctions[Event::EVENT_TYPE_COUNT] =
+        {
+            nullptr,
+            shipBatch<KeyDownEvent, &EventListener::onKeyDownBatch>,
+            shipBatch<KeyUpEvent, &EventListener::onKeyUpBatch>,
+            shipBatch<MouseButtonDownEvent, &EventListener::onMouseButtonDownBatch>,
+            shipBatch<MouseButtonUpEvent, &EventListener::onMouseButtonUpBatch>,
+            shipBatch<MouseMoveEvent, &EventListener::onMouseMoveBatch>,
+            shipBatch<RawMouseMoveEvent, &EventListener::onRawMouseMoveBatch>,
+            shipBatch<MouseWheelEvent, &EventListener::onMouseWheelBatch>,
+            shipBatch<WindowResizeEvent, &EventListener::onWindowResizeBatch>,
+            shipBatch<WindowMinimizeEvent, &EventListener::onWindowMinimizeBatch>,
+            shipBatch<WindowRestoreEvent, &EventListener::onWindowRestoreBatch>,
+            shipBatch<WindowFocusLostEvent, &EventListener::onWindowFocusLostBatch>,
+            shipBatch<WindowFocusGainedEvent, &EventListener::onWindowFocusGainedBatch>
+        };
     }
 
     void EventListener::shipEvent(Event& e)
     {
         onEvent(e);
-        switch(e.getEventType())
-        {
-            case Event::KEY_DOWN:
-                onKeyDown((KeyDownEvent&)e);
-                    break;
-            case Event::KEY_UP:
-                onKeyUp((KeyUpEvent&)e);
-                    break;
-            case Event::MOUSE_BUTTON_DOWN:
-                onMouseButtonDown((MouseButtonDownEvent&)e);
-                    break;
-            case Event::MOUSE_BUTTON_UP:
-                onMouseButtonUp((MouseButtonUpEvent&)e);
-                    break;
-            case Event::MOUSE_MOVE:
-                onMouseMove((MouseMoveEvent&)e);
-                    break;
-            }
+
+        EventShipFunction ship = typedShipFunctions[e.getEventType()];
+        if(ship)
+            ship(this, e);
     }
 
     EventHandler* EventHandler::getEventHandler() 
@@ -91,16 +224,159 @@ namespace Dawn
         return eventDispathcer;
     }
 
-    void EventDispatcher::addEventListener(EventListener* eventListener)
+    ListenerHandle EventDispatcher::subscribe(uint32 list, EventListener* eventListener, int32 priority,
+                                              EventShipFunction ship, EventBatchShipFunction shipBatch)
     {
-        eventListeners.push_back(eventListener);
+        uint32 slot;
+        if(!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slots.emplace_back();
+            slot = (uint32)(slots.size() - 1);
+        }
+
+        slots[slot].list = list;
+        ListenerHandle handle = (uint64)slots[slot].generation << 32 | slot;
+        Subscription subscription = { eventListener, handle, priority, ship, shipBatch };
+
+        // inserting now could reallocate the array a dispatch is walking
+        if(dispatchDepth > 0)
+            pendingSubscriptions.push_back({ list, subscription });
+        else
+            insert(list, subscription);
+
+        return handle;
+    }
+
+    void EventDispatcher::insert(uint32 list, const Subscription& subscription)
+    {
+        std::vector<Subscription>& listeners = subscriptions[list];
+
+        // after every listener of the same priority, usually that's the end
+        if(listeners.empty() || listeners.back().priority >= subscription.priority)
+        {
+            listeners.push_back(subscription);
+            return;
+        }
+
+        auto position = std::upper_bound(listeners.begin(), listeners.end(), subscription, [](const Subscription& a, const Subscription& b){
+            return a.priority > b.priority;
+        });
+        listeners.insert(position, subscription);
+    }
+
+    void EventDispatcher::release(uint32 slot)
+    {
+        // stale handles and list entries stop matching, 0 stays reserved for INVALID_HANDLE
+        if(++slots[slot].generation == 0)
+            slots[slot].generation = 1;
+
+        staleCounts[slots[slot].list]++;
+        slots[slot].list = NIL;
+        freeSlots.push_back(slot);
+    }
+
+    void EventDispatcher::compact(uint32 list)
+    {
+        std::vector<Subscription>& listeners = subscriptions[list];
+        listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [this](const Subscription& s){
+            return !isAlive(s.handle);
+        }), listeners.end());
+
+        staleCounts[list] = 0;
+    }
+
+    void EventDispatcher::beginDispatch(uint32 list)
+    {
+        if(dispatchDepth == 0 && staleCounts[list] > 0)
+            compact(list);
+
+        dispatchDepth++;
+    }
+
+    void EventDispatcher::endDispatch()
+    {
+        if(--dispatchDepth > 0)
+            return;
+
+        // by index, a listener may still subscribe while they're appended
+        for(size_t i = 0; i < pendingSubscriptions.size(); i++)
+        {
+            PendingSubscription& pending = pendingSubscriptions[i];
+            if(isAlive(pending.subscription.handle))
+                insert(pending.list, pending.subscription);
+            else
+                staleCounts[pending.list]--;
+        }
+
+        pendingSubscriptions.clear();
+    }
+
+    void EventDispatcher::addEventListener(EventListener* eventListener, int32 priority)
+    {
+        for(uint32 type = Event::NONE + 1; type < Event::EVENT_TYPE_COUNT; type++)
+        {
+            // raw motion duplicates MOUSE_MOVE, it has to be asked for explicitly
+            if(type != Event::RAW_MOUSE_MOVE)
+                subscribe(type, eventListener, priority, shipAll, nullptr);
+        }
+    }
+
+    ListenerHandle EventDispatcher::addEventListener(EventListener* eventListener, Event::EventType eventType, int32 priority)
+    {
+        return subscribe(eventType, eventListener, priority, typedShipFunctions[eventType], nullptr);
+    }
+
+    ListenerHandle EventDispatcher::addBatchListener(EventListener* eventListener, Event::EventType eventType, int32 priority)
+    {
+        return subscribe(Event::EVENT_TYPE_COUNT + eventType, eventListener, priority, nullptr, batchShipFunctions[eventType]);
+    }
+
+    bool EventDispatcher::removeEventListener(ListenerHandle handle)
+    {
+        uint32 slot = (uint32)handle;
+        if(handle == INVALID_HANDLE || slot >= slots.size() || !isAlive(handle))
+            return false;
+
+        release(slot);
+        return true;
+    }
+
+    void EventDispatcher::removeFromList(EventListener* eventListener, uint32 list)
+    {
+        for(auto& subscription : subscriptions[list])
+        {
+            if(subscription.listener == eventListener && isAlive(subscription.handle))
+                release((uint32)subscription.handle);
+        }
+
+        for(auto& pending : pendingSubscriptions)
+        {
+            if(pending.list == list && pending.subscription.listener == eventListener && isAlive(pending.subscription.handle))
+                release((uint32)pending.subscription.handle);
+        }
     }
 
     void EventDispatcher::removeEventListener(EventListener* eventListener)
     {
-        eventListeners.erase(std::remove_if(eventListeners.begin(), 
-                             eventListeners.end(), [eventListener](EventListener* e){
-            return (e == eventListener);
-        }));
+        for(uint32 type = Event::NONE + 1; type < Event::EVENT_TYPE_COUNT; type++)
+        {
+            removeEventListener(eventListener, (Event::EventType)type);
+            removeBatchListener(eventListener, (Event::EventType)type);
+        }
+    }
+
+    void EventDispatcher::removeEventListener(EventListener* eventListener, Event::EventType eventType)
+    {
+        removeFromList(eventListener, eventType);
+    }
+
+    void EventDispatcher::removeBatchListener(EventListener* eventListener, Event::EventType eventType)
+    {
+        removeFromList(eventListener, Event::EVENT_TYPE_COUNT + eventType);
     }
-}
\ No newline at end of file
+}
@@ -3,5 +3,6 @@
 #include "event_interface.h"
 #include "key_events.h"
 #include "mouse_events.h"
+#include "window_events.h"
 #include "event_dispatcher.h"
 #include "event_listener.h"
@@ -0,0 +1,146 @@
+#include "input_recording.h"
+#include <fstream>
+#include "core/log.h"
+
+namespace Dawn
+{
+    // written as is, a layout change needs a new INPUT_RECORDING_VERSION
+    static_assert(sizeof(QueuedEvent) == 20, "QueuedEvent layout changed");
+    static_assert(sizeof(RecordedFrame) == 8, "RecordedFrame layout changed");
+
+    bool readInputRecording(const std::string& path, InputRecording& recording)
+    {
+        std::ifstream file(path, std::ios::binary);
+        InputRecordingHeader& header = recording.header;
+        if(!file.read((char*)&header, sizeof(header)))
+            return false;
+
+        if(header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION)
+            return false;
+
+        // a corrupt or truncated file must not size the arrays, the counts
+        // have to match what's left of it
+        std::streamoff dataOffset = file.tellg();
+        file.seekg(0, std::ios::end);
+        uint64 dataSize = (uint64)(file.tellg() - dataOffset);
+        file.seekg(dataOffset);
+        if(!file || (uint64)header.frameCount * sizeof(RecordedFrame) + (uint64)header.eventCount * sizeof(QueuedEvent) != dataSize)
+            return false;
+
+        recording.frames.resize(header.frameCount);
+        recording.events.resize(header.eventCount);
+        if(!file.read((char*)recording.frames.data(), header.frameCount * sizeof(RecordedFrame)) ||
+           !file.read((char*)recording.events.data(), header.eventCount * sizeof(QueuedEvent)))
+            return false;
+
+        // the frames have to account for exactly the events stored
+        uint64 eventCount = 0;
+        for(auto& frame : recording.frames)
+            eventCount += frame.eventCount;
+
+        return eventCount == header.eventCount;
+    }
+
+    bool writeInputRecording(const std::string& path, const InputRecording& recording)
+    {
+        std::ofstream file(path, std::ios::binary);
+        InputRecordingHeader header = recording.header;
+        header.frameCount = (uint32)recording.frames.size();
+        header.eventCount = (uint32)recording.events.size();
+
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)recording.frames.data(), recording.frames.size() * sizeof(RecordedFrame));
+        file.write((const char*)recording.events.data(), recording.events.size() * sizeof(QueuedEvent));
+
+        return (bool)file;
+    }
+
+    void InputRecorder::start()
+    {
+        m_recording = InputRecording();
+        m_start = Clock::now();
+        m_frameEvents = 0;
+        m_lastTimestampUs = 0;
+        m_isRecording = true;
+    }
+
+    void InputRecorder::record(const QueuedEvent& event)
+    {
+        m_recording.events.push_back(event);
+        m_frameEvents++;
+    }
+
+    double InputRecorder::endFrame()
+    {
+        uint32 timestampUs = (uint32)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_start).count();
+        m_recording.frames.push_back({ timestampUs, m_frameEvents });
+        m_frameEvents = 0;
+
+        // from the stored timestamps, so the replay computes the very same value
+        double frameSeconds = (timestampUs - m_lastTimestampUs) / 1000000.0;
+        m_lastTimestampUs = timestampUs;
+        return frameSeconds;
+    }
+
+    bool InputRecorder::stop(const std::string& path)
+    {
+        m_isRecording = false;
+        if(!writeInputRecording(path, m_recording))
+        {
+            DAWN_INTERNAL_ERROR("Couldn't write input recording {}", path);
+            return false;
+        }
+
+        DAWN_INTERNAL_INFO("Recorded {} frames, {} events to {}", m_recording.frames.size(), m_recording.events.size(), path);
+        return true;
+    }
+
+    bool InputPlayer::start(const std::string& path)
+    {
+        m_frame = 0;
+        m_nextEvent = 0;
+        m_isPlaying = readInputRecording(path, m_recording);
+        if(!m_isPlaying)
+        {
+            DAWN_INTERNAL_ERROR("Couldn't read input recording {}", path);
+            return false;
+        }
+
+        // an empty recording has nothing to replay
+        m_isPlaying = m_recording.header.frameCount > 0;
+        return true;
+    }
+
+    void InputPlayer::stop()
+    {
+        m_isPlaying = false;
+    }
+
+    const QueuedEvent* InputPlayer::getFrameEvents(uint32& count) const
+    {
+        count = m_isPlaying ? m_recording.frames[m_frame].eventCount : 0;
+        return count > 0 ? &m_recording.events[m_nextEvent] : nullptr;
+    }
+
+    double InputPlayer::getFrameSeconds() const
+    {
+        if(!m_isPlaying)
+            return 0.0;
+
+        uint32 previousUs = m_frame > 0 ? m_recording.frames[m_frame - 1].timestampUs : 0;
+        return (m_recording.frames[m_frame].timestampUs - previousUs) / 1000000.0;
+    }
+
+    void InputPlayer::endFrame()
+    {
+        if(!m_isPlaying)
+            return;
+
+        m_nextEvent += m_recording.frames[m_frame].eventCount;
+        if(++m_frame == m_recording.header.frameCount)
+        {
+            m_isPlaying = false;
+            DAWN_INTERNAL_INFO("Input replay finished after {} frames", m_frame);
+        }
+    }
+}
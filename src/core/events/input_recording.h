@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "core/common.h"
+#include "queued_event.h"
+
+namespace Dawn
+{
+	// .drec file, little endian:
+	//   InputRecordingHeader
+	//   frameCount x RecordedFrame  in frame order, the index is the position
+	//   eventCount x QueuedEvent    in dispatch order, each frame's events back to back
+	const uint32 INPUT_RECORDING_MAGIC = 0x43455244; // "DREC"
+	const uint32 INPUT_RECORDING_VERSION = 1;
+
+	struct InputRecordingHeader
+	{
+		uint32 magic{INPUT_RECORDING_MAGIC};
+		uint32 version{INPUT_RECORDING_VERSION};
+		uint32 frameCount{};
+		uint32 eventCount{};
+	};
+
+	struct RecordedFrame
+	{
+		// when the frame's events were drained, since the recording started
+		uint32 timestampUs;
+		uint32 eventCount;
+	};
+
+	struct InputRecording
+	{
+		InputRecordingHeader header{};
+		std::vector<RecordedFrame> frames{};
+		std::vector<QueuedEvent> events{};
+	};
+
+	bool readInputRecording(const std::string& path, InputRecording& recording);
+	bool writeInputRecording(const std::string& path, const InputRecording& recording);
+
+	// Collects the platform events of every drained frame.
+	class InputRecorder
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		InputRecording m_recording{};
+		Clock::time_point m_start{};
+		uint32 m_frameEvents{};
+		uint32 m_lastTimestampUs{};
+		bool m_isRecording{};
+
+		DAWN_NULL_COPY_AND_ASSIGN(InputRecorder)
+	public:
+		InputRecorder() {}
+		~InputRecorder() {}
+
+		void start();
+		void record(const QueuedEvent& event);
+		// Closes the current frame, also when it had no events, and returns
+		// its length as it will be replayed.
+		double endFrame();
+		// Writes what was recorded and stops, false if the file couldn't be written.
+		bool stop(const std::string& path);
+
+		inline bool isRecording() const { return m_isRecording; }
+	};
+
+	// Hands a recording back one frame at a time, in place of the live events.
+	class InputPlayer
+	{
+		InputRecording m_recording{};
+		uint32 m_frame{};
+		uint32 m_nextEvent{};
+		bool m_isPlaying{};
+
+		DAWN_NULL_COPY_AND_ASSIGN(InputPlayer)
+	public:
+		InputPlayer() {}
+		~InputPlayer() {}
+
+		bool start(const std::string& path);
+		void stop();
+
+		// Events of the current frame, empty once the recording ran out.
+		const QueuedEvent* getFrameEvents(uint32& count) const;
+		// Time the current frame took when it was recorded.
+		double getFrameSeconds() const;
+		// Moves to the next frame, stops after the last one.
+		void endFrame();
+
+		inline bool isPlaying() const { return m_isPlaying; }
+		inline uint32 getFrame() const { return m_frame; }
+		inline uint32 getFrameCount() const { return m_recording.header.frameCount; }
+	};
+}
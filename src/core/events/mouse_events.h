@@ -44,5 +44,23 @@ namespace Dawn
 		int32 posX{}, posY{};
 		int32 deltaX{}, deltaY{};
 	};
+
+	// Same payload as MouseMoveEvent, but one per motion event the platform
+	// reported, even when MOUSE_MOVE is coalesced to one per frame.
+	struct RawMouseMoveEvent : public MouseMoveEvent
+	{
+		RawMouseMoveEvent()  { eventType = Event::RAW_MOUSE_MOVE; }
+	};
+
+	struct MouseWheelEvent : public Event
+	{
+		MouseWheelEvent()  { eventType = Event::MOUSE_WHEEL; }
+
+		// positive is away from the user and to the right
+		inline const int32& getWheelX() const { return wheelX; }
+		inline const int32& getWheelY() const { return wheelY; }
+
+		int32 wheelX{}, wheelY{};
+	};
 }
 
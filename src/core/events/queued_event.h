@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/common.h"
+#include "event_interface.h"
+
+namespace Dawn
+{
+	struct KeyEventData
+	{
+		uint32 keyCode;
+		bool isRepeat;
+	};
+
+	struct MouseButtonEventData
+	{
+		uint32 mouseButton;
+		uint32 numClicks;
+		int32 posX;
+		int32 posY;
+	};
+
+	struct MouseMoveEventData
+	{
+		int32 posX;
+		int32 posY;
+		int32 deltaX;
+		int32 deltaY;
+	};
+
+	struct MouseWheelEventData
+	{
+		int32 wheelX;
+		int32 wheelY;
+	};
+
+	struct WindowEventData
+	{
+		uint32 width;
+		uint32 height;
+	};
+
+	// Plain copy of an event's payload, the form events travel through the queues in.
+	struct QueuedEvent
+	{
+		Event::EventType type;
+		union
+		{
+			KeyEventData key;
+			MouseButtonEventData mouseButton;
+			MouseMoveEventData mouseMove;
+			MouseWheelEventData mouseWheel;
+			WindowEventData window;
+		};
+	};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "event_interface.h"
+#include "core/common.h"
+
+namespace Dawn
+{
+	struct WindowResizeEvent : public Event
+	{
+		WindowResizeEvent() { eventType = Event::WINDOW_RESIZE; }
+
+		inline const uint32& getWidth() const { return width; }
+		inline const uint32& getHeight() const { return height; }
+
+		uint32 width{};
+		uint32 height{};
+	};
+
+	struct WindowMinimizeEvent : public Event
+	{
+		WindowMinimizeEvent() { eventType = Event::WINDOW_MINIMIZE; }
+	};
+
+	struct WindowRestoreEvent : public Event
+	{
+		WindowRestoreEvent() { eventType = Event::WINDOW_RESTORE; }
+	};
+
+	struct WindowFocusLostEvent : public Event
+	{
+		WindowFocusLostEvent() { eventType = Event::WINDOW_FOCUS_LOST; }
+	};
+
+	struct WindowFocusGainedEvent : public Event
+	{
+		WindowFocusGainedEvent() { eventType = Event::WINDOW_FOCUS_GAINED; }
+	};
+}
@@ -0,0 +1,86 @@
+#include "fixed_timestep.h"
+#include <algorithm>
+
+namespace Dawn
+{
+	namespace
+	{
+		const float STEPS_SMOOTHING = 0.05f;
+		// a variable step never exceeds this, e.g. after a breakpoint
+		const double MAX_VARIABLE_STEP_SECONDS = 0.25;
+	}
+
+	void FixedTimestep::setStepRate(uint32 stepsPerSecond)
+	{
+		m_requestedStepRate = std::max<uint32>(stepsPerSecond, 1);
+	}
+
+	void FixedTimestep::applySettings()
+	{
+		bool isEnabled = m_requestedEnabled;
+		if(isEnabled != m_isEnabled)
+		{
+			m_isEnabled = isEnabled;
+			m_accumulator = 0.0;
+		}
+
+		uint32 stepRate = m_requestedStepRate;
+		if(stepRate != m_stepRate)
+		{
+			m_stepRate = stepRate;
+			m_stepSeconds = 1.0 / m_stepRate;
+			// keep the fraction of a step, not the absolute time
+			m_accumulator = std::min(m_accumulator, m_stepSeconds);
+		}
+
+		m_maxStepsPerFrame = m_requestedMaxSteps;
+	}
+
+	double FixedTimestep::measureFrame()
+	{
+		Clock::time_point now = Clock::now();
+		double frameSeconds = m_hasLastFrame ? std::chrono::duration<double>(now - m_lastFrame).count() : 0.0;
+		m_lastFrame = now;
+		m_hasLastFrame = true;
+		return frameSeconds;
+	}
+
+	uint32 FixedTimestep::beginFrame()
+	{
+		return beginFrame(measureFrame());
+	}
+
+	uint32 FixedTimestep::beginFrame(double frameSeconds)
+	{
+		applySettings();
+		m_frameSeconds = frameSeconds;
+
+		uint32 steps = 1;
+		if(m_isEnabled)
+		{
+			m_accumulator += m_frameSeconds;
+			steps = (uint32)(m_accumulator / m_stepSeconds);
+
+			if(steps > m_maxStepsPerFrame)
+			{
+				double dropped = (steps - m_maxStepsPerFrame) * m_stepSeconds;
+				m_stats.clampedFrames++;
+				m_stats.droppedMs += (float)(dropped * 1000.0);
+				m_accumulator -= dropped;
+				steps = m_maxStepsPerFrame;
+			}
+
+			m_accumulator -= steps * m_stepSeconds;
+		}
+		else
+		{
+			m_frameSeconds = std::min(m_frameSeconds, MAX_VARIABLE_STEP_SECONDS);
+		}
+
+		m_stats.stepRate = m_stepRate;
+		m_stats.stepsLastFrame = steps;
+		m_stats.averageStepsPerFrame += (steps - m_stats.averageStepsPerFrame) * STEPS_SMOOTHING;
+
+		return steps;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <glm/glm.hpp>
+#include "common.h"
+
+namespace Dawn
+{
+	struct FixedTimestepStats
+	{
+		uint32 stepRate{};
+		uint32 stepsLastFrame{};
+		float averageStepsPerFrame{};
+		// frames that hit the max steps clamp and the simulated time they lost
+		uint32 clampedFrames{};
+		float droppedMs{};
+	};
+
+	// Accumulates real frame time and hands it out as whole simulation steps.
+	// The left over fraction of a step is the interpolation factor between the
+	// last two simulated states. When disabled every frame is a single step of
+	// the measured frame time with nothing left to interpolate.
+	class FixedTimestep
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		// what the setters asked for, any thread writes them and the thread
+		// running the steps picks them up when its next frame begins
+		std::atomic<bool> m_requestedEnabled{true};
+		std::atomic<uint32> m_requestedStepRate{60};
+		std::atomic<uint32> m_requestedMaxSteps{5};
+
+		bool m_isEnabled{true};
+		uint32 m_stepRate{60};
+		uint32 m_maxStepsPerFrame{5};
+
+		double m_stepSeconds{1.0 / 60.0};
+		double m_accumulator{};
+		double m_frameSeconds{};
+		Clock::time_point m_lastFrame{};
+		bool m_hasLastFrame{};
+
+		FixedTimestepStats m_stats{};
+
+		void applySettings();
+
+		DAWN_NULL_COPY_AND_ASSIGN(FixedTimestep)
+	public:
+		FixedTimestep() {}
+		~FixedTimestep() {}
+
+		// The settings apply when the next frame begins, so the main thread
+		// can change them while a pipelined frame is being simulated.
+		inline void setEnabled(bool isEnabled) { m_requestedEnabled = isEnabled; }
+		inline bool isEnabled() const { return m_requestedEnabled; }
+
+		// Simulation steps per second.
+		void setStepRate(uint32 stepsPerSecond);
+		// Beyond this the remaining time is dropped so a slow frame can't
+		// cause more steps the next frame and spiral.
+		inline void setMaxStepsPerFrame(uint32 steps) { m_requestedMaxSteps = steps; }
+
+		// Seconds since the last call, 0 on the first. Can run on another
+		// thread than the steps, e.g. the main thread of a pipelined frame.
+		double measureFrame();
+		// Makes the next measured frame 0 long, e.g. after the loop idled, so
+		// the wait isn't simulated as one long frame.
+		inline void resync() { m_hasLastFrame = false; }
+		// Measures the time since the last call and returns how many steps to run.
+		uint32 beginFrame();
+		// Same with a given frame time, e.g. a measured or recorded one. Leaves
+		// the clock alone, measureFrame() has to run every frame regardless or
+		// the next measured frame spans every frame stepped this way.
+		uint32 beginFrame(double frameSeconds);
+
+		inline float getStepSeconds() const { return (float)(m_isEnabled ? m_stepSeconds : m_frameSeconds); }
+		// 0 renders the previous state, 1 the current one.
+		inline float getAlpha() const { return m_isEnabled ? (float)(m_accumulator / m_stepSeconds) : 1.0f; }
+
+		inline const FixedTimestepStats& getStats() const { return m_stats; }
+	};
+
+	// Position kept at the last two simulation steps so rendering can blend them.
+	struct InterpolatedTransform
+	{
+		glm::vec2 previous{};
+		glm::vec2 current{};
+
+		// Call at the start of each simulation step, before moving.
+		inline void beginStep() { previous = current; }
+		// Moves without interpolating, e.g. when spawning or teleporting.
+		inline void reset(const glm::vec2& pos) { previous = pos; current = pos; }
+		inline glm::vec2 get(float alpha) const { return previous + (current - previous) * alpha; }
+	};
+}
@@ -0,0 +1,117 @@
+#include "frame_pacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace Dawn
+{
+	namespace
+	{
+		// spun on top of the expected sleep overshoot
+		const float SPIN_PADDING_MS = 0.2f;
+		// a single long stall shouldn't turn the pacer into a busy loop
+		const float MAX_SLEEP_OVERSHOOT_MS = 4.0f;
+		// the overshoot estimate rises at once and decays at this rate
+		const float OVERSHOOT_DECAY = 0.05f;
+		const float INTERVAL_SMOOTHING = 0.05f;
+
+		inline float toMilliseconds(std::chrono::steady_clock::duration duration)
+		{
+			return std::chrono::duration<float, std::milli>(duration).count();
+		}
+	}
+
+	void FramePacer::setFrameRateCap(uint32 framesPerSecond)
+	{
+		m_frameRateCap = framesPerSecond;
+		m_interval = Clock::duration::zero();
+		if(framesPerSecond > 0)
+			m_interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond));
+
+		m_deadline = Clock::now() + m_interval;
+	}
+
+	void FramePacer::waitForNextFrame()
+	{
+		m_stats.sleptMs = 0.0f;
+		m_stats.spunMs = 0.0f;
+
+		Clock::time_point now = Clock::now();
+		if(m_frameRateCap == 0)
+		{
+			recordInterval(now);
+			return;
+		}
+
+		if(now >= m_deadline)
+		{
+			// restart the cadence instead of rushing frames to catch up
+			m_stats.missedDeadlines++;
+			m_deadline = now;
+		}
+		else
+		{
+			float marginMs = m_sleepOvershootMs + SPIN_PADDING_MS;
+			Clock::time_point wakeUp = m_deadline - std::chrono::duration_cast<Clock::duration>(
+				std::chrono::duration<float, std::milli>(marginMs));
+
+			if(wakeUp > now)
+			{
+				std::this_thread::sleep_for(wakeUp - now);
+				Clock::time_point woke = Clock::now();
+
+				float overshootMs = std::min(toMilliseconds(woke - wakeUp), MAX_SLEEP_OVERSHOOT_MS);
+				if(overshootMs > m_sleepOvershootMs)
+					m_sleepOvershootMs = overshootMs;
+				else
+					m_sleepOvershootMs += (overshootMs - m_sleepOvershootMs) * OVERSHOOT_DECAY;
+
+				m_stats.sleptMs = toMilliseconds(woke - now);
+				now = woke;
+			}
+
+			Clock::time_point spinStart = now;
+			while(now < m_deadline)
+			{
+				std::this_thread::yield();
+				now = Clock::now();
+			}
+			m_stats.spunMs = toMilliseconds(now - spinStart);
+		}
+
+		m_deadline += m_interval;
+		m_stats.sleepOvershootMs = m_sleepOvershootMs;
+		recordInterval(now);
+	}
+
+	void FramePacer::resync()
+	{
+		m_deadline = Clock::now() + m_interval;
+		m_hasLastFrame = false;
+	}
+
+	void FramePacer::recordInterval(Clock::time_point now)
+	{
+		m_stats.targetIntervalMs = m_frameRateCap > 0 ? 1000.0f / m_frameRateCap : 0.0f;
+
+		if(!m_hasLastFrame)
+		{
+			m_lastFrame = now;
+			m_hasLastFrame = true;
+			return;
+		}
+
+		float intervalMs = toMilliseconds(now - m_lastFrame);
+		m_lastFrame = now;
+
+		if(m_stats.averageIntervalMs == 0.0f)
+			m_stats.averageIntervalMs = intervalMs;
+		else
+			m_stats.averageIntervalMs += (intervalMs - m_stats.averageIntervalMs) * INTERVAL_SMOOTHING;
+
+		float deviationMs = std::fabs(intervalMs - m_stats.averageIntervalMs);
+		m_stats.jitterMs += (deviationMs - m_stats.jitterMs) * INTERVAL_SMOOTHING;
+		m_stats.maxJitterMs = std::max(m_stats.maxJitterMs, deviationMs);
+		m_stats.lastIntervalMs = intervalMs;
+	}
+}
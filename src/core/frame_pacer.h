@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include "common.h"
+
+namespace Dawn
+{
+	enum class VsyncMode
+	{
+		OFF,
+		ON,
+		// swaps late frames immediately instead of waiting a full refresh,
+		// falls back to ON where the driver doesn't support it
+		ADAPTIVE
+	};
+
+	struct FramePacingStats
+	{
+		float targetIntervalMs{};
+		float lastIntervalMs{};
+		float averageIntervalMs{};
+		// smoothed absolute deviation of the interval from its average
+		float jitterMs{};
+		float maxJitterMs{};
+
+		// how the last wait was spent
+		float sleptMs{};
+		float spunMs{};
+		// current estimate of how late the OS wakes us from a sleep
+		float sleepOvershootMs{};
+
+		uint32 missedDeadlines{};
+	};
+
+	// Caps the frame rate by sleeping until shortly before the deadline and
+	// spinning the rest, so we neither burn a core nor add the wake-up latency
+	// of a plain sleep. The spin margin follows the measured sleep overshoot.
+	class FramePacer
+	{
+		typedef std::chrono::steady_clock Clock;
+
+		uint32 m_frameRateCap{};
+		Clock::duration m_interval{};
+		Clock::time_point m_deadline{};
+		Clock::time_point m_lastFrame{};
+		bool m_hasLastFrame{};
+
+		float m_sleepOvershootMs{1.0f};
+
+		FramePacingStats m_stats{};
+
+		void recordInterval(Clock::time_point now);
+
+		DAWN_NULL_COPY_AND_ASSIGN(FramePacer)
+	public:
+		FramePacer() {}
+		~FramePacer() {}
+
+		// 0 disables the cap.
+		void setFrameRateCap(uint32 framesPerSecond);
+		inline uint32 getFrameRateCap() const { return m_frameRateCap; }
+
+		// Call once per frame after the swap, blocks until the next frame is due.
+		void waitForNextFrame();
+
+		// Call after the loop idled, so the idle time isn't taken as a late frame.
+		void resync();
+
+		inline const FramePacingStats& getStats() const { return m_stats; }
+		inline void resetStats() { m_stats = FramePacingStats(); m_hasLastFrame = false; }
+	};
+}
@@ -0,0 +1,180 @@
+#include "frame_pipeline.h"
+#include <algorithm>
+
+namespace Dawn
+{
+	namespace
+	{
+		const float STAGE_SMOOTHING = 0.05f;
+
+		typedef std::chrono::steady_clock Clock;
+
+		inline float toMilliseconds(Clock::duration duration)
+		{
+			return std::chrono::duration<float, std::milli>(duration).count();
+		}
+	}
+
+	FramePipeline::~FramePipeline()
+	{
+		if(m_isRunning)
+			stop();
+	}
+
+	void FramePipeline::start(uint32 depth, const SimulateCallback& simulate)
+	{
+		m_depth = std::min(std::max<uint32>(depth, 1), MAX_DEPTH);
+		// slots are kept across restarts so their batches keep their GL objects
+		if(m_frames.size() < m_depth)
+			m_frames.resize(m_depth);
+		m_states.assign(m_depth, SlotState::FREE);
+
+		m_simulate = simulate;
+		m_inputFrame = 0;
+		m_submitFrame = 0;
+		m_stats = FramePipelineStats();
+		m_stats.depth = m_depth;
+		m_isRunning = true;
+
+		m_simulateThread = std::thread(&FramePipeline::simulateLoop, this);
+		m_buildThread = std::thread(&FramePipeline::buildLoop, this);
+	}
+
+	void FramePipeline::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isRunning = false;
+		}
+		m_stateChanged.notify_all();
+
+		m_simulateThread.join();
+		m_buildThread.join();
+	}
+
+	bool FramePipeline::waitForState(uint32 slot, SlotState state, float& waitMs)
+	{
+		Clock::time_point start = Clock::now();
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stateChanged.wait(lock, [&]() { return !m_isRunning || m_states[slot] == state; });
+
+		waitMs = toMilliseconds(Clock::now() - start);
+		return m_isRunning;
+	}
+
+	void FramePipeline::setState(uint32 slot, SlotState state)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_states[slot] = state;
+		}
+		m_stateChanged.notify_all();
+	}
+
+	void FramePipeline::recordStage(FrameStage stage, float busyMs, float waitMs)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		FrameStageStats& stats = m_stats.stages[(uint32)stage];
+		stats.lastMs = busyMs;
+		stats.averageMs += (busyMs - stats.averageMs) * STAGE_SMOOTHING;
+		stats.averageWaitMs += (waitMs - stats.averageWaitMs) * STAGE_SMOOTHING;
+	}
+
+	void FramePipeline::simulateLoop()
+	{
+		for(uint64 frame = 0; ; frame++)
+		{
+			uint32 slot = (uint32)(frame % m_depth);
+			float waitMs = 0.0f;
+			if(!waitForState(slot, SlotState::QUEUED, waitMs))
+				return;
+
+			Clock::time_point start = Clock::now();
+
+			FrameSnapshot& snapshot = m_frames[slot].snapshot;
+			snapshot.frame = frame;
+			snapshot.sprites.clear();
+			snapshot.lights.clear();
+			m_simulate(snapshot);
+
+			recordStage(FrameStage::SIMULATE, toMilliseconds(Clock::now() - start), waitMs);
+			setState(slot, SlotState::SIMULATED);
+		}
+	}
+
+	void FramePipeline::buildLoop()
+	{
+		for(uint64 frame = 0; ; frame++)
+		{
+			uint32 slot = (uint32)(frame % m_depth);
+			float waitMs = 0.0f;
+			if(!waitForState(slot, SlotState::SIMULATED, waitMs))
+				return;
+
+			Clock::time_point start = Clock::now();
+			build(m_frames[slot]);
+
+			recordStage(FrameStage::BUILD, toMilliseconds(Clock::now() - start), waitMs);
+			setState(slot, SlotState::BUILT);
+		}
+	}
+
+	void FramePipeline::build(PipelineFrame& frame)
+	{
+		const FrameSnapshot& snapshot = frame.snapshot;
+		SpriteBatch& batch = frame.batch;
+
+		batch.setViewport(snapshot.viewportWidth, snapshot.viewportHeight);
+		batch.setDepthSorting(snapshot.isDepthSorted);
+		batch.begin();
+		for(const Sprite& sprite : snapshot.sprites)
+			batch.add(sprite.texture, sprite.normalMap, sprite.pos, sprite.size, sprite.depth, sprite.isOpaque);
+		batch.prepare();
+	}
+
+	FrameInput& FramePipeline::beginInput()
+	{
+		uint32 slot = (uint32)(m_inputFrame % m_depth);
+		float waitMs = 0.0f;
+		waitForState(slot, SlotState::FREE, waitMs);
+		return m_frames[slot].snapshot.input;
+	}
+
+	void FramePipeline::endInput()
+	{
+		uint32 slot = (uint32)(m_inputFrame % m_depth);
+		m_inputFrame++;
+		setState(slot, SlotState::QUEUED);
+	}
+
+	PipelineFrame& FramePipeline::beginSubmit()
+	{
+		uint32 slot = (uint32)(m_submitFrame % m_depth);
+		waitForState(slot, SlotState::BUILT, m_submitWaitMs);
+
+		m_submitStart = Clock::now();
+		return m_frames[slot];
+	}
+
+	void FramePipeline::endSubmit()
+	{
+		uint32 slot = (uint32)(m_submitFrame % m_depth);
+		recordStage(FrameStage::SUBMIT, toMilliseconds(Clock::now() - m_submitStart), m_submitWaitMs);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stats.framesSubmitted++;
+		}
+
+		m_submitFrame++;
+		setState(slot, SlotState::FREE);
+	}
+
+	FramePipelineStats FramePipeline::getStats()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_stats;
+	}
+}
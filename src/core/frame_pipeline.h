@@ -0,0 +1,154 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common.h"
+#include "spritebatch.h"
+#include "input_state.h"
+#include "action_map.h"
+#include "graphics/light_culling.h"
+#include "graphics/debug_draw.h"
+
+namespace Dawn
+{
+	// Everything the simulation of a frame reads from the main thread, captured
+	// there once the frame's events are drained.
+	struct FrameInput
+	{
+		// real time the frame covers
+		double frameSeconds{};
+		uint32 windowWidth{};
+		uint32 windowHeight{};
+		InputState inputState{};
+		ActionStates actions{};
+	};
+
+	// What the simulation hands to rendering. The input is written by the
+	// main thread before the simulate stage, the rest only by the simulate
+	// stage, and all of it is read-only for every later stage of the frame.
+	struct FrameSnapshot
+	{
+		uint64 frame{};
+		FrameInput input{};
+		uint32 viewportWidth{};
+		uint32 viewportHeight{};
+		// see SpriteBatch::setDepthSorting(), the targets drawn to have a depth buffer
+		bool isDepthSorted{true};
+		std::vector<Sprite> sprites{};
+		// culled against the render target when the frame is submitted
+		std::vector<PointLight> lights{};
+		// drawn over the frame's sprites, see DAWN_DEBUG_DRAW_TAKE()
+		DebugPrimitives debugPrimitives{};
+	};
+
+	struct PipelineFrame
+	{
+		FrameSnapshot snapshot{};
+		// prepared on the build thread, flushed on the GL thread
+		SpriteBatch batch{};
+	};
+
+	enum class FrameStage
+	{
+		SIMULATE,
+		BUILD,
+		SUBMIT
+	};
+
+	struct FrameStageStats
+	{
+		float lastMs{};
+		float averageMs{};
+		// time the stage spent blocked on its neighbours
+		float averageWaitMs{};
+	};
+
+	struct FramePipelineStats
+	{
+		static const uint32 STAGE_COUNT = 3;
+
+		uint32 depth{};
+		uint64 framesSubmitted{};
+		// indexed by FrameStage, the stage with the least waiting is the critical path
+		FrameStageStats stages[STAGE_COUNT]{};
+	};
+
+	// Runs simulation of frame N+1 on one thread and command building of frame
+	// N on another while the GL thread submits frame N-1. Frames move through a
+	// ring of depth slots, so at most depth frames are in flight and a stage
+	// blocks when the next one falls behind. The simulate stage only runs
+	// frames the main thread gave input to. Depth 1 runs the stages serially.
+	class FramePipeline
+	{
+	public:
+		typedef std::function<void(FrameSnapshot&)> SimulateCallback;
+
+		static const uint32 MAX_DEPTH = 4;
+
+	private:
+		enum class SlotState
+		{
+			FREE,
+			// input written, waiting for the simulate stage
+			QUEUED,
+			SIMULATED,
+			BUILT
+		};
+
+		std::vector<PipelineFrame> m_frames{};
+		std::vector<SlotState> m_states{};
+		uint32 m_depth{};
+
+		SimulateCallback m_simulate{};
+		std::thread m_simulateThread{};
+		std::thread m_buildThread{};
+		std::mutex m_mutex{};
+		std::condition_variable m_stateChanged{};
+		bool m_isRunning{};
+
+		uint64 m_inputFrame{};
+		uint64 m_submitFrame{};
+		float m_submitWaitMs{};
+		std::chrono::steady_clock::time_point m_submitStart{};
+
+		FramePipelineStats m_stats{};
+
+		void simulateLoop();
+		void buildLoop();
+		// Blocks until the slot reaches the state, false once stopped.
+		bool waitForState(uint32 slot, SlotState state, float& waitMs);
+		void setState(uint32 slot, SlotState state);
+		void recordStage(FrameStage stage, float busyMs, float waitMs);
+
+		DAWN_NULL_COPY_AND_ASSIGN(FramePipeline)
+	public:
+		FramePipeline() {}
+		~FramePipeline();
+
+		void start(uint32 depth, const SimulateCallback& simulate);
+		// Waits for the stages to finish their current frame, unsubmitted frames are dropped.
+		void stop();
+		inline bool isRunning() const { return m_isRunning; }
+		inline uint32 getDepth() const { return m_depth; }
+
+		// Main thread: waits for a free slot and returns the input of the next
+		// frame to simulate, which is handed over by endInput().
+		FrameInput& beginInput();
+		void endInput();
+		// Frames given input and not submitted yet, at most the depth.
+		inline uint32 getFramesInFlight() const { return (uint32)(m_inputFrame - m_submitFrame); }
+
+		// GL thread: waits for the oldest built frame, which stays valid until endSubmit().
+		PipelineFrame& beginSubmit();
+		void endSubmit();
+
+		// The build stage, also used to run a frame without the pipeline.
+		static void build(PipelineFrame& frame);
+
+		FramePipelineStats getStats();
+	};
+}
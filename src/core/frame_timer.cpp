@@ -0,0 +1,146 @@
+#include "frame_timer.h"
+#include <algorithm>
+
+namespace Dawn
+{
+	namespace
+	{
+		inline float toMilliseconds(std::chrono::steady_clock::duration duration)
+		{
+			return std::chrono::duration<float, std::milli>(duration).count();
+		}
+
+		inline float percentile(std::vector<float>& values, float fraction)
+		{
+			// nearest rank, nth_element leaves the rest partially ordered for the next query
+			size_t rank = (size_t)(fraction * (values.size() - 1) + 0.5f);
+			std::nth_element(values.begin(), values.begin() + rank, values.end());
+			return values[rank];
+		}
+	}
+
+	uint32 FrameTimer::getBucket(float milliseconds)
+	{
+		uint32 bucket = milliseconds > 0.0f ? (uint32)milliseconds : 0;
+		return std::min(bucket, HISTOGRAM_BUCKETS - 1);
+	}
+
+	void FrameTimer::beginFrame()
+	{
+		Clock::time_point now = Clock::now();
+
+		if(m_isFrameOpen)
+		{
+			FrameTiming timing;
+			timing.cpuMs = toMilliseconds(m_cpuEnd - m_frameBegin);
+			timing.wallMs = toMilliseconds(now - m_frameBegin);
+			timing.presentIntervalMs = m_presentIntervalMs;
+			record(timing);
+		}
+
+		m_frameBegin = now;
+		m_cpuEnd = now;
+		m_presentIntervalMs = 0.0f;
+		m_isFrameOpen = true;
+	}
+
+	void FrameTimer::endCpuWork()
+	{
+		m_cpuEnd = Clock::now();
+	}
+
+	void FrameTimer::markPresent()
+	{
+		Clock::time_point now = Clock::now();
+		if(m_hasPresented)
+			m_presentIntervalMs = toMilliseconds(now - m_lastPresent);
+
+		m_lastPresent = now;
+		m_hasPresented = true;
+	}
+
+	float FrameTimer::getFrameElapsedMs() const
+	{
+		return m_isFrameOpen ? toMilliseconds(Clock::now() - m_frameBegin) : 0.0f;
+	}
+
+	void FrameTimer::skipFrame()
+	{
+		m_isFrameOpen = false;
+		m_hasPresented = false;
+	}
+
+	void FrameTimer::record(const FrameTiming& timing)
+	{
+		FrameTiming& slot = m_timings[m_next];
+
+		if(m_count == CAPACITY)
+		{
+			m_cpuSum -= slot.cpuMs;
+			m_wallSum -= slot.wallMs;
+			m_presentSum -= slot.presentIntervalMs;
+			m_histogram[getBucket(slot.wallMs)]--;
+		}
+		else
+		{
+			m_count++;
+		}
+
+		slot = timing;
+		m_cpuSum += timing.cpuMs;
+		m_wallSum += timing.wallMs;
+		m_presentSum += timing.presentIntervalMs;
+		m_histogram[getBucket(timing.wallMs)]++;
+
+		m_next = (m_next + 1) % CAPACITY;
+		m_isDirty = true;
+	}
+
+	const FrameTiming& FrameTimer::getFrame(uint32 index) const
+	{
+		uint32 oldest = m_count == CAPACITY ? m_next : 0;
+		return m_timings[(oldest + index) % CAPACITY];
+	}
+
+	const FrameTimingStats& FrameTimer::getStats() const
+	{
+		if(!m_isDirty)
+			return m_stats;
+
+		m_stats = FrameTimingStats();
+		m_stats.frames = m_count;
+		m_isDirty = false;
+
+		if(m_count == 0)
+			return m_stats;
+
+		m_stats.averageFps = getAverageFps();
+		m_stats.averageCpuMs = (float)(m_cpuSum / m_count);
+		m_stats.averageWallMs = (float)(m_wallSum / m_count);
+		m_stats.averagePresentIntervalMs = (float)(m_presentSum / m_count);
+
+		m_sorted.resize(m_count);
+		for(uint32 i = 0; i < m_count; i++)
+			m_sorted[i] = m_timings[i].wallMs;
+
+		m_stats.maxMs = *std::max_element(m_sorted.begin(), m_sorted.end());
+		m_stats.p50Ms = percentile(m_sorted, 0.50f);
+		m_stats.p95Ms = percentile(m_sorted, 0.95f);
+		m_stats.p99Ms = percentile(m_sorted, 0.99f);
+
+		return m_stats;
+	}
+
+	void FrameTimer::reset()
+	{
+		m_next = 0;
+		m_count = 0;
+		std::fill(m_histogram, m_histogram + HISTOGRAM_BUCKETS, 0);
+		m_cpuSum = 0.0;
+		m_wallSum = 0.0;
+		m_presentSum = 0.0;
+		m_isFrameOpen = false;
+		m_hasPresented = false;
+		m_isDirty = true;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "common.h"
+
+namespace Dawn
+{
+	struct FrameTiming
+	{
+		// begin of the frame until the swap is issued
+		float cpuMs;
+		// begin of the frame until the begin of the next one
+		float wallMs;
+		// between the returns of two consecutive swaps
+		float presentIntervalMs;
+	};
+
+	struct FrameTimingStats
+	{
+		uint32 frames{};
+		float averageFps{};
+
+		float averageCpuMs{};
+		float averageWallMs{};
+		float averagePresentIntervalMs{};
+
+		// percentiles over the wall time of the recorded window
+		float p50Ms{};
+		float p95Ms{};
+		float p99Ms{};
+		float maxMs{};
+	};
+
+	// Records the timings of the last CAPACITY frames into a ring buffer.
+	// Recording and the histogram are O(1) per frame; percentiles are only
+	// computed when the stats are asked for, at most once per frame.
+	class FrameTimer
+	{
+	public:
+		static const uint32 CAPACITY = 256;
+		// one millisecond wide buckets, the last one collects everything slower
+		static const uint32 HISTOGRAM_BUCKETS = 64;
+
+	private:
+		typedef std::chrono::steady_clock Clock;
+
+		FrameTiming m_timings[CAPACITY]{};
+		uint32 m_next{};
+		uint32 m_count{};
+		uint32 m_histogram[HISTOGRAM_BUCKETS]{};
+
+		// running sums over the window, updated as frames enter and leave it
+		double m_cpuSum{};
+		double m_wallSum{};
+		double m_presentSum{};
+
+		Clock::time_point m_frameBegin{};
+		Clock::time_point m_cpuEnd{};
+		Clock::time_point m_lastPresent{};
+		bool m_isFrameOpen{};
+		bool m_hasPresented{};
+		float m_presentIntervalMs{};
+
+		mutable FrameTimingStats m_stats{};
+		mutable std::vector<float> m_sorted{};
+		mutable bool m_isDirty{};
+
+		void record(const FrameTiming& timing);
+		static uint32 getBucket(float milliseconds);
+
+		DAWN_NULL_COPY_AND_ASSIGN(FrameTimer)
+	public:
+		FrameTimer() {}
+		~FrameTimer() {}
+
+		// Closes the previous frame, whose wall time ends here.
+		void beginFrame();
+		// Right before the swap.
+		void endCpuWork();
+		// Right after the swap returns.
+		void markPresent();
+		// Drops the open frame, e.g. when the loop idled instead of rendering.
+		void skipFrame();
+
+		// Since the begin of the open frame, 0 when none is open.
+		float getFrameElapsedMs() const;
+		inline float getAverageFps() const { return m_wallSum > 0.0 ? (float)(m_count * 1000.0 / m_wallSum) : 0.0f; }
+		const FrameTimingStats& getStats() const;
+		inline const uint32* getHistogram() const { return m_histogram; }
+		inline uint32 getFrameCount() const { return m_count; }
+		// 0 is the oldest recorded frame.
+		const FrameTiming& getFrame(uint32 index) const;
+
+		void reset();
+	};
+}
@@ -0,0 +1,74 @@
+#include "compressed_texture.h"
+#include <fstream>
+
+namespace Dawn
+{
+	namespace
+	{
+		bool isValidHeader(const CompressedTextureHeader& header)
+		{
+			return header.magic == COMPRESSED_TEXTURE_MAGIC &&
+			       header.version == COMPRESSED_TEXTURE_VERSION &&
+			       header.format <= ETC2_RGBA8_EAC &&
+			       header.width > 0 && header.height > 0 &&
+			       // bounds the level loop before anything is read per level
+			       header.mipCount > 0 && header.mipCount <= getMaxMipCount(header.width, header.height);
+		}
+	}
+
+	bool readCompressedTextureHeader(const std::string& path, CompressedTextureHeader& header)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if(!file.read((char*)&header, sizeof(header)))
+			return false;
+
+		return isValidHeader(header);
+	}
+
+	bool readCompressedTexture(const std::string& path, CompressedTexture& texture)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if(!file.read((char*)&texture.header, sizeof(texture.header)) || !isValidHeader(texture.header))
+			return false;
+
+		const CompressedTextureHeader& header = texture.header;
+		texture.mips.resize(header.mipCount);
+
+		uint32 width = header.width;
+		uint32 height = header.height;
+		for(auto& mip : texture.mips)
+		{
+			uint32 byteSize = 0;
+			if(!file.read((char*)&byteSize, sizeof(byteSize)))
+				return false;
+
+			if(byteSize != getCompressedMipSize(header.format, width, height))
+				return false;
+
+			mip.resize(byteSize);
+			if(!file.read((char*)mip.data(), byteSize))
+				return false;
+
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+
+		return true;
+	}
+
+	bool writeCompressedTexture(const std::string& path, const CompressedTexture& texture)
+	{
+		std::ofstream file(path, std::ios::binary);
+		if(!file.write((const char*)&texture.header, sizeof(texture.header)))
+			return false;
+
+		for(auto& mip : texture.mips)
+		{
+			uint32 byteSize = (uint32)mip.size();
+			file.write((const char*)&byteSize, sizeof(byteSize));
+			file.write((const char*)mip.data(), byteSize);
+		}
+
+		return (bool)file;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "core/common.h"
+
+namespace Dawn
+{
+	// .dtex container, little endian:
+	//   CompressedTextureHeader
+	//   mipCount x { uint32 byteSize; uint8 data[byteSize]; }  largest mip first
+	const uint32 COMPRESSED_TEXTURE_MAGIC = 0x58455444; // "DTEX"
+	const uint32 COMPRESSED_TEXTURE_VERSION = 1;
+
+	enum CompressedTextureFormat : uint32
+	{
+		ETC2_RGB8 = 0,       // GL_COMPRESSED_RGB8_ETC2, 8 bytes per 4x4 block
+		ETC2_RGBA8_EAC = 1   // GL_COMPRESSED_RGBA8_ETC2_EAC, 16 bytes per 4x4 block
+	};
+
+	struct CompressedTextureHeader
+	{
+		uint32 magic{COMPRESSED_TEXTURE_MAGIC};
+		uint32 version{COMPRESSED_TEXTURE_VERSION};
+		uint32 format{};
+		uint32 width{};
+		uint32 height{};
+		uint32 mipCount{};
+	};
+
+	struct CompressedTexture
+	{
+		CompressedTextureHeader header{};
+		std::vector<std::vector<uint8>> mips{};
+	};
+
+	inline uint32 getCompressedBlockSize(uint32 format)
+	{
+		return format == ETC2_RGBA8_EAC ? 16 : 8;
+	}
+
+	inline uint32 getCompressedMipSize(uint32 format, uint32 width, uint32 height)
+	{
+		return ((width + 3) / 4) * ((height + 3) / 4) * getCompressedBlockSize(format);
+	}
+
+	// Levels of a full chain down to 1x1, floor(log2(max(width, height))) + 1.
+	inline uint32 getMaxMipCount(uint32 width, uint32 height)
+	{
+		uint32 count = 1;
+		for(uint32 size = width > height ? width : height; size > 1; size /= 2)
+			count++;
+		return count;
+	}
+
+	bool readCompressedTextureHeader(const std::string& path, CompressedTextureHeader& header);
+	bool readCompressedTexture(const std::string& path, CompressedTexture& texture);
+	bool writeCompressedTexture(const std::string& path, const CompressedTexture& texture);
+}
@@ -0,0 +1,234 @@
+#include "debug_draw.h"
+
+#ifdef DAWN_ENABLE_DEBUG_DRAW
+
+#include <cmath>
+#include <cstddef>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "shader.h"
+
+namespace Dawn
+{
+	namespace
+	{
+		const GLchar* vertexShaderSource = {
+		R"(
+			#version 300 es
+
+			layout (location = 0) in vec2 pos;
+			layout (location = 1) in vec4 colorIn;
+
+			uniform mat4 mvp;
+
+			out vec4 vertexColor;
+
+			void main()
+			{
+				gl_Position = mvp * vec4(pos, 0.0f, 1.0f);
+				vertexColor = colorIn;
+			}
+		)"
+		};
+
+		const GLchar* fragmentShaderSource = {
+		R"(
+			#version 300 es
+
+			precision mediump float;
+
+			in vec4 vertexColor;
+			out vec4 color;
+
+			void main()
+			{
+				color = vertexColor;
+			}
+		)"
+		};
+
+		inline uint32 packColor(const glm::vec4& color)
+		{
+			auto channel = [](float c) { return (uint32)(c < 0.0f ? 0.0f : (c > 1.0f ? 255.0f : c * 255.0f + 0.5f)); };
+			return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16 | channel(color.w) << 24;
+		}
+	}
+
+	DebugDraw& DebugDraw::getDebugDraw()
+	{
+		static DebugDraw debugDraw;
+		return debugDraw;
+	}
+
+	void DebugDraw::initGL()
+	{
+		glGenVertexArrays(1, &m_vertexArray);
+		glBindVertexArray(m_vertexArray);
+
+		glGenBuffers(1, &m_vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, x));
+
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, color));
+
+		glBindVertexArray(0);
+
+		m_shaderProgram = createShaderProgram(vertexShaderSource, fragmentShaderSource);
+		m_mvpLocation = glGetUniformLocation(m_shaderProgram, "mvp");
+	}
+
+	void DebugDraw::line(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color)
+	{
+		uint32 packed = packColor(color);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_lines.push_back({ from.x, from.y, packed });
+		m_lines.push_back({ to.x, to.y, packed });
+	}
+
+	void DebugDraw::rect(const glm::vec2& pos, const glm::vec2& size, const glm::vec4& color, bool isFilled)
+	{
+		glm::vec2 corners[4] =
+		{
+			pos,
+			glm::vec2(pos.x + size.x, pos.y),
+			pos + size,
+			glm::vec2(pos.x, pos.y + size.y)
+		};
+
+		uint32 packed = packColor(color);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		appendPolygon(corners, 4, packed, isFilled);
+	}
+
+	void DebugDraw::circle(const glm::vec2& center, float radius, const glm::vec4& color, bool isFilled, uint32 segments)
+	{
+		if(segments < 3)
+			segments = 3;
+
+		uint32 packed = packColor(color);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::vector<glm::vec2>& points = m_scratchPoints;
+		points.resize(segments);
+
+		// rotate a unit vector instead of calling sin/cos per segment
+		float angle = 2.0f * 3.14159265f / segments;
+		float c = std::cos(angle);
+		float s = std::sin(angle);
+		float x = radius;
+		float y = 0.0f;
+		for(uint32 i = 0; i < segments; i++)
+		{
+			points[i] = glm::vec2(center.x + x, center.y + y);
+			float rotatedX = c * x - s * y;
+			y = s * x + c * y;
+			x = rotatedX;
+		}
+
+		appendPolygon(points.data(), segments, packed, isFilled);
+	}
+
+	void DebugDraw::polygon(const glm::vec2* points, uint32 count, const glm::vec4& color, bool isFilled)
+	{
+		uint32 packed = packColor(color);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		appendPolygon(points, count, packed, isFilled);
+	}
+
+	void DebugDraw::appendPolygon(const glm::vec2* points, uint32 count, uint32 packed, bool isFilled)
+	{
+		if(count < 2)
+			return;
+
+		if(isFilled)
+		{
+			for(uint32 i = 1; i + 1 < count; i++)
+			{
+				m_triangles.push_back({ points[0].x, points[0].y, packed });
+				m_triangles.push_back({ points[i].x, points[i].y, packed });
+				m_triangles.push_back({ points[i + 1].x, points[i + 1].y, packed });
+			}
+			return;
+		}
+
+		for(uint32 i = 0; i < count; i++)
+		{
+			const glm::vec2& next = points[(i + 1) % count];
+			m_lines.push_back({ points[i].x, points[i].y, packed });
+			m_lines.push_back({ next.x, next.y, packed });
+		}
+	}
+
+	void DebugDraw::setViewport(uint32 width, uint32 height)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_viewportWidth = width;
+		m_viewportHeight = height;
+	}
+
+	uint32 DebugDraw::getVertexCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return (uint32)(m_triangles.size() + m_lines.size());
+	}
+
+	void DebugDraw::take(DebugPrimitives& primitives)
+	{
+		// what the frame drew last time it went around the pipeline is
+		// already flushed, its buffers are reused for the next primitives
+		primitives.clear();
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_triangles.swap(primitives.triangles);
+		m_lines.swap(primitives.lines);
+	}
+
+	void DebugDraw::flush(const DebugPrimitives& primitives)
+	{
+		const std::vector<DebugVertex>& triangles = primitives.triangles;
+		const std::vector<DebugVertex>& lines = primitives.lines;
+		if(triangles.empty() && lines.empty())
+			return;
+
+		uint32 viewportWidth;
+		uint32 viewportHeight;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			viewportWidth = m_viewportWidth;
+			viewportHeight = m_viewportHeight;
+		}
+
+		if(m_shaderProgram == 0)
+			initGL();
+
+		m_modelViewProj = glm::ortho(0.0f, (float)viewportWidth, (float)viewportHeight, 0.0f, -1.0f, 1.0f);
+
+		glUseProgram(m_shaderProgram);
+		glUniformMatrix4fv(m_mvpLocation, 1, GL_FALSE, glm::value_ptr(m_modelViewProj));
+
+		// triangles first, lines after them in the same buffer
+		GLsizeiptr trianglesSize = triangles.size() * sizeof(DebugVertex);
+		GLsizeiptr linesSize = lines.size() * sizeof(DebugVertex);
+
+		glBindVertexArray(m_vertexArray);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, trianglesSize + linesSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, trianglesSize, triangles.data());
+		glBufferSubData(GL_ARRAY_BUFFER, trianglesSize, linesSize, lines.data());
+
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		if(!triangles.empty())
+			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)triangles.size());
+		if(!lines.empty())
+			glDrawArrays(GL_LINES, (GLint)triangles.size(), (GLsizei)lines.size());
+
+		glDisable(GL_BLEND);
+		glBindVertexArray(0);
+	}
+}
+
+#endif
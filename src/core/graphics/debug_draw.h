@@ -0,0 +1,105 @@
+#pragma once
+
+// Immediate mode debug primitives, accumulated from any thread and taken by
+// the simulation of a frame into its snapshot, which carries them through
+// the pipeline. flush() draws a frame's primitives on the GL thread with one
+// draw for filled shapes and one for outlines, so they show on the sprites
+// of the frame they were added for. Use the DAWN_DEBUG_* macros so calls
+// disappear when DAWN_ENABLE_DEBUG_DRAW is off (every build type but Debug).
+
+#include <vector>
+#include "core/common.h"
+
+namespace Dawn
+{
+	struct DebugVertex
+	{
+		float x, y;
+		uint32 color;
+	};
+
+	// Primitives of one frame, empty when debug draw is compiled out.
+	struct DebugPrimitives
+	{
+		std::vector<DebugVertex> triangles{};
+		std::vector<DebugVertex> lines{};
+
+		inline void clear() { triangles.clear(); lines.clear(); }
+	};
+}
+
+#ifdef DAWN_ENABLE_DEBUG_DRAW
+
+#include <mutex>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+
+namespace Dawn
+{
+	class DebugDraw
+	{
+		DebugDraw() {}
+		~DebugDraw() {}
+
+		// guards the primitives added since the last take()
+		mutable std::mutex m_mutex{};
+		std::vector<DebugVertex> m_triangles{};
+		std::vector<DebugVertex> m_lines{};
+		std::vector<glm::vec2> m_scratchPoints{};
+
+		glm::mat4 m_modelViewProj{1.0f};
+		uint32 m_viewportWidth{800};
+		uint32 m_viewportHeight{600};
+
+		GLuint m_vertexArray{};
+		GLuint m_vertexBuffer{};
+		GLuint m_shaderProgram{};
+		GLint m_mvpLocation{-1};
+
+		void initGL();
+		// Callers hold m_mutex.
+		void appendPolygon(const glm::vec2* points, uint32 count, uint32 color, bool isFilled);
+
+		DAWN_NULL_COPY_AND_ASSIGN(DebugDraw)
+	public:
+		static const uint32 DEFAULT_CIRCLE_SEGMENTS = 24;
+
+		static DebugDraw& getDebugDraw();
+
+		void line(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color);
+		void rect(const glm::vec2& pos, const glm::vec2& size, const glm::vec4& color, bool isFilled = false);
+		void circle(const glm::vec2& center, float radius, const glm::vec4& color, bool isFilled = false,
+		            uint32 segments = DEFAULT_CIRCLE_SEGMENTS);
+		// Filled polygons are triangulated as a fan, so they have to be convex.
+		void polygon(const glm::vec2* points, uint32 count, const glm::vec4& color, bool isFilled = false);
+
+		void setViewport(uint32 width, uint32 height);
+		// Simulation of a frame, at its end: moves everything added since the
+		// last take() into the frame's primitives.
+		void take(DebugPrimitives& primitives);
+		// GL thread, draws the primitives of the submitted frame.
+		void flush(const DebugPrimitives& primitives);
+
+		uint32 getVertexCount() const;
+	};
+}
+
+#define DAWN_DEBUG_LINE(...)     ::Dawn::DebugDraw::getDebugDraw().line(__VA_ARGS__)
+#define DAWN_DEBUG_RECT(...)     ::Dawn::DebugDraw::getDebugDraw().rect(__VA_ARGS__)
+#define DAWN_DEBUG_CIRCLE(...)   ::Dawn::DebugDraw::getDebugDraw().circle(__VA_ARGS__)
+#define DAWN_DEBUG_POLYGON(...)  ::Dawn::DebugDraw::getDebugDraw().polygon(__VA_ARGS__)
+#define DAWN_DEBUG_DRAW_VIEWPORT(width, height) ::Dawn::DebugDraw::getDebugDraw().setViewport(width, height)
+#define DAWN_DEBUG_DRAW_TAKE(primitives)  ::Dawn::DebugDraw::getDebugDraw().take(primitives)
+#define DAWN_DEBUG_DRAW_FLUSH(primitives) ::Dawn::DebugDraw::getDebugDraw().flush(primitives)
+
+#else
+
+#define DAWN_DEBUG_LINE(...)
+#define DAWN_DEBUG_RECT(...)
+#define DAWN_DEBUG_CIRCLE(...)
+#define DAWN_DEBUG_POLYGON(...)
+#define DAWN_DEBUG_DRAW_VIEWPORT(width, height)
+#define DAWN_DEBUG_DRAW_TAKE(primitives)
+#define DAWN_DEBUG_DRAW_FLUSH(primitives)
+
+#endif
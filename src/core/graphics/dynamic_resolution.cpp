@@ -0,0 +1,194 @@
+#include "dynamic_resolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Dawn
+{
+	namespace
+	{
+		// weight of the newest frame in the smoothed frame time
+		const float FRAME_TIME_SMOOTHING = 0.1f;
+
+		// the dead band between the two keeps the scale from oscillating
+		const float DECREASE_THRESHOLD = 1.05f;
+		const float INCREASE_THRESHOLD = 0.85f;
+
+		// changes smaller than this are not worth a visible resolution step
+		const float MIN_SCALE_CHANGE = 0.01f;
+
+		// a stuck GPU shows up as a long frame instead of a hung loop
+		const GLuint64 GPU_WAIT_TIMEOUT_NS = 100000000;
+	}
+
+	void DynamicResolution::shutdown()
+	{
+		if(m_framebuffer == 0)
+			return;
+
+		glDeleteFramebuffers(1, &m_framebuffer);
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_framebuffer = 0;
+		m_colorBuffer = 0;
+		m_depthBuffer = 0;
+		m_targetWidth = 0;
+		m_targetHeight = 0;
+	}
+
+	void DynamicResolution::setEnabled(bool isEnabled)
+	{
+		m_isEnabled = isEnabled;
+		m_stats.scale = m_maxScale;
+		resync();
+		DAWN_INTERNAL_INFO("Dynamic resolution {}", m_isEnabled ? "enabled" : "disabled");
+	}
+
+	void DynamicResolution::setScaleRange(float minScale, float maxScale)
+	{
+		m_minScale = minScale;
+		m_maxScale = maxScale;
+		m_stats.scale = std::min(std::max(m_stats.scale, m_minScale), m_maxScale);
+	}
+
+	void DynamicResolution::resizeTarget(uint32 width, uint32 height)
+	{
+		if(m_framebuffer == 0)
+		{
+			glGenFramebuffers(1, &m_framebuffer);
+			glGenRenderbuffers(1, &m_colorBuffer);
+			glGenRenderbuffers(1, &m_depthBuffer);
+		}
+
+		glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		DAWN_INTERNAL_ASSERT(status == GL_FRAMEBUFFER_COMPLETE, "Dynamic resolution target incomplete");
+
+		m_targetWidth = width;
+		m_targetHeight = height;
+	}
+
+	void DynamicResolution::updateScale(float frameMs)
+	{
+		// a hitch such as a window drag shouldn't throw the average off for seconds
+		frameMs = std::min(frameMs, m_targetFrameMs * 4.0f);
+
+		if(m_stats.frameMs == 0.0f)
+			m_stats.frameMs = frameMs;
+		else
+			m_stats.frameMs += (frameMs - m_stats.frameMs) * FRAME_TIME_SMOOTHING;
+
+		m_stats.targetFrameMs = m_targetFrameMs;
+		m_stats.lastDecision = ScaleDecision::HOLD;
+		m_stats.framesSinceChange++;
+
+		if(m_stats.framesSinceChange < m_cooldownFrames)
+			return;
+
+		// fill-bound cost grows with the pixel count, the square of the scale
+		float scale = m_stats.scale;
+		float desired = scale * std::sqrt(m_targetFrameMs / m_stats.frameMs);
+
+		if(m_stats.frameMs > m_targetFrameMs * DECREASE_THRESHOLD)
+			desired = std::max(desired, scale - m_maxScaleStep);
+		else if(m_stats.frameMs < m_targetFrameMs * INCREASE_THRESHOLD)
+			// creep back up slower than we back off
+			desired = std::min(desired, scale + m_maxScaleStep * 0.5f);
+		else
+			return;
+
+		desired = std::min(std::max(desired, m_minScale), m_maxScale);
+		if(std::fabs(desired - scale) < MIN_SCALE_CHANGE)
+			return;
+
+		if(desired < scale)
+		{
+			m_stats.lastDecision = ScaleDecision::DECREASE;
+			m_stats.decreases++;
+		}
+		else
+		{
+			m_stats.lastDecision = ScaleDecision::INCREASE;
+			m_stats.increases++;
+		}
+
+		m_stats.scale = desired;
+		m_stats.framesSinceChange = 0;
+	}
+
+	void DynamicResolution::beginFrame(uint32 windowWidth, uint32 windowHeight)
+	{
+		m_windowWidth = windowWidth;
+		m_windowHeight = windowHeight;
+
+		if(!m_isEnabled)
+		{
+			m_stats.renderWidth = windowWidth;
+			m_stats.renderHeight = windowHeight;
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, windowWidth, windowHeight);
+			return;
+		}
+
+		uint32 targetWidth = (uint32)std::ceil(windowWidth * m_maxScale);
+		uint32 targetHeight = (uint32)std::ceil(windowHeight * m_maxScale);
+		if(targetWidth != m_targetWidth || targetHeight != m_targetHeight)
+			resizeTarget(targetWidth, targetHeight);
+
+		m_stats.renderWidth = std::max<uint32>(1, (uint32)(windowWidth * m_stats.scale + 0.5f));
+		m_stats.renderHeight = std::max<uint32>(1, (uint32)(windowHeight * m_stats.scale + 0.5f));
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glViewport(0, 0, m_stats.renderWidth, m_stats.renderHeight);
+	}
+
+	void DynamicResolution::endFrame()
+	{
+		if(!m_isEnabled)
+			return;
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		glBlitFramebuffer(0, 0, m_stats.renderWidth, m_stats.renderHeight,
+		                  0, 0, m_windowWidth, m_windowHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+		// nothing reads the scene depth after the blit, tilers can skip storing it
+		GLenum depthAttachment = GL_DEPTH_ATTACHMENT;
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, &depthAttachment);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, m_windowWidth, m_windowHeight);
+	}
+
+	void DynamicResolution::waitForGpu()
+	{
+		if(!m_isEnabled)
+			return;
+
+		GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GPU_WAIT_TIMEOUT_NS);
+		glDeleteSync(fence);
+	}
+
+	void DynamicResolution::addFrameTime(float milliseconds)
+	{
+		if(m_isEnabled)
+			updateScale(milliseconds);
+	}
+
+	void DynamicResolution::resync()
+	{
+		// the next frame seeds the smoothed time, the cooldown lets a few more in first
+		m_stats.frameMs = 0.0f;
+		m_stats.framesSinceChange = 0;
+	}
+}
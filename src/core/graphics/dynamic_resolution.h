@@ -0,0 +1,95 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "core/common.h"
+
+namespace Dawn
+{
+	enum class ScaleDecision
+	{
+		HOLD,
+		INCREASE,
+		DECREASE
+	};
+
+	struct DynamicResolutionStats
+	{
+		float scale{1.0f};
+		uint32 renderWidth{};
+		uint32 renderHeight{};
+
+		// smoothed frame time the controller acts on
+		float frameMs{};
+		float targetFrameMs{};
+
+		ScaleDecision lastDecision{ScaleDecision::HOLD};
+		uint32 increases{};
+		uint32 decreases{};
+		uint32 framesSinceChange{};
+	};
+
+	// Renders the scene into an offscreen target sized for the largest scale and
+	// draws into a scaled sub-rectangle of it, so scale changes never reallocate.
+	// The scale follows the measured frame time against the target budget and
+	// the result is upscaled to the window with a linear blit.
+	class DynamicResolution
+	{
+		bool m_isEnabled{};
+
+		float m_targetFrameMs{1000.0f / 60.0f};
+		float m_minScale{0.5f};
+		float m_maxScale{1.0f};
+		// largest change of a single decision
+		float m_maxScaleStep{0.1f};
+		// frames to wait after a change so the smoothed time reflects it
+		uint32 m_cooldownFrames{8};
+
+		uint32 m_windowWidth{};
+		uint32 m_windowHeight{};
+
+		GLuint m_framebuffer{};
+		GLuint m_colorBuffer{};
+		GLuint m_depthBuffer{};
+		uint32 m_targetWidth{};
+		uint32 m_targetHeight{};
+
+		DynamicResolutionStats m_stats{};
+
+		void resizeTarget(uint32 width, uint32 height);
+		void updateScale(float frameMs);
+
+		DAWN_NULL_COPY_AND_ASSIGN(DynamicResolution)
+	public:
+		DynamicResolution() {}
+		~DynamicResolution() {}
+
+		// Needs a live GL context, releases the offscreen target.
+		void shutdown();
+
+		void setEnabled(bool isEnabled);
+		inline bool isEnabled() const { return m_isEnabled; }
+
+		inline void setTargetFrameTime(float milliseconds) { m_targetFrameMs = milliseconds; }
+		void setScaleRange(float minScale, float maxScale);
+
+		// Binds the target the scene is drawn into with a viewport matching the
+		// current scale.
+		void beginFrame(uint32 windowWidth, uint32 windowHeight);
+		// Upscales the scene to the default framebuffer and leaves it bound.
+		void endFrame();
+
+		// Right before the swap, blocks on a fence until the GPU finished the
+		// frame. Timing the frame up to here covers its CPU and GPU work but
+		// not the time the swap blocks on vsync. No-op while disabled.
+		void waitForGpu();
+		// Feeds the render cost of the last frame, from its begin until
+		// waitForGpu() returned, which picks the scale of the frames after it.
+		// Swap blocking, frame rate cap sleeps and idle waits must not be
+		// part of it, they'd keep it at the refresh interval or above.
+		void addFrameTime(float milliseconds);
+		// Forgets the frame time history, e.g. after the loop idled.
+		void resync();
+
+		inline const DynamicResolutionStats& getStats() const { return m_stats; }
+	};
+}
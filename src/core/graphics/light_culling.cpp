@@ -0,0 +1,260 @@
+#include "light_culling.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Dawn
+{
+	namespace
+	{
+		void createDataTexture(GLuint& texture)
+		{
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			// integer and float textures are fetched with texelFetch, no filtering
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+	}
+
+	TiledLightCuller::~TiledLightCuller()
+	{
+		if(m_isRunning)
+			shutdown();
+	}
+
+	void TiledLightCuller::init(uint32 workerCount)
+	{
+		m_isRunning = true;
+		for(uint32 i = 0; i < workerCount; i++)
+			m_workers.emplace_back(&TiledLightCuller::workerLoop, this);
+	}
+
+	void TiledLightCuller::shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isRunning = false;
+		}
+		m_workAvailable.notify_all();
+
+		for(auto& worker : m_workers)
+			worker.join();
+		m_workers.clear();
+	}
+
+	void TiledLightCuller::setViewport(uint32 width, uint32 height)
+	{
+		m_viewportWidth = width;
+		m_viewportHeight = height;
+	}
+
+	void TiledLightCuller::workerLoop()
+	{
+		uint32 generation = 0;
+		while(true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_workAvailable.wait(lock, [&]() { return !m_isRunning || m_generation != generation; });
+				if(!m_isRunning)
+					return;
+				generation = m_generation;
+			}
+
+			binRows();
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(--m_activeWorkers == 0)
+				m_workDone.notify_one();
+		}
+	}
+
+	void TiledLightCuller::binRows()
+	{
+		for(uint32 row = m_nextRow++; row < m_tilesY; row = m_nextRow++)
+			binRow(row);
+	}
+
+	void TiledLightCuller::binRow(uint32 row)
+	{
+		const std::vector<PointLight>& lights = *m_lights;
+		float tileSize = (float)m_tileSize;
+		float rowTop = row * tileSize;
+		float rowBottom = rowTop + tileSize;
+
+		uint16* counts = &m_tileCounts[row * m_tilesX];
+		std::fill(counts, counts + m_tilesX, 0);
+		uint32 overflowed = 0;
+
+		uint32 lightCount = (uint32)std::min<size_t>(lights.size(), MAX_LIGHTS);
+		for(uint32 i = 0; i < lightCount; i++)
+		{
+			// lights are given in sprite units, tiles are in render target pixels
+			glm::vec2 pos = lights[i].pos * m_pixelScale;
+			float radius = lights[i].radius * m_pixelScale;
+			if(pos.y + radius < rowTop || pos.y - radius > rowBottom)
+				continue;
+
+			int32 firstTile = std::max(0, (int32)std::floor((pos.x - radius) / tileSize));
+			int32 lastTile = std::min((int32)m_tilesX - 1, (int32)std::floor((pos.x + radius) / tileSize));
+
+			// closest point of the row to the light, the x part varies per tile
+			float dy = std::max(std::max(rowTop - pos.y, pos.y - rowBottom), 0.0f);
+			float radiusSquared = radius * radius;
+
+			for(int32 tile = firstTile; tile <= lastTile; tile++)
+			{
+				float tileLeft = tile * tileSize;
+				float dx = std::max(std::max(tileLeft - pos.x, pos.x - tileLeft - tileSize), 0.0f);
+				if(dx * dx + dy * dy > radiusSquared)
+					continue;
+
+				// a full tile keeps count at max + 1 to flag the overflow once
+				uint16& count = counts[tile];
+				if(count >= m_maxLightsPerTile)
+				{
+					if(count == m_maxLightsPerTile)
+					{
+						overflowed++;
+						count++;
+					}
+					continue;
+				}
+
+				m_tileSlots[(row * m_tilesX + tile) * m_maxLightsPerTile + count++] = (uint16)i;
+			}
+		}
+
+		m_overflowedTiles += overflowed;
+	}
+
+	void TiledLightCuller::compact()
+	{
+		uint32 tileCount = m_tilesX * m_tilesY;
+		m_tileHeaders.resize(tileCount * 2);
+		m_lightIndices.clear();
+
+		uint32 maxLights = 0;
+		for(uint32 tile = 0; tile < tileCount; tile++)
+		{
+			uint32 count = std::min<uint32>(m_tileCounts[tile], m_maxLightsPerTile);
+			m_tileHeaders[tile * 2] = (uint32)m_lightIndices.size();
+			m_tileHeaders[tile * 2 + 1] = count;
+
+			const uint16* slots = &m_tileSlots[tile * m_maxLightsPerTile];
+			m_lightIndices.insert(m_lightIndices.end(), slots, slots + count);
+			maxLights = std::max(maxLights, count);
+		}
+
+		uint32 totalIndices = (uint32)m_lightIndices.size();
+
+		// pad to whole rows of the index texture
+		uint32 rows = std::max<uint32>(1, ((uint32)m_lightIndices.size() + INDEX_TEXTURE_WIDTH - 1) / INDEX_TEXTURE_WIDTH);
+		m_lightIndices.resize(rows * INDEX_TEXTURE_WIDTH, 0);
+
+		const std::vector<PointLight>& lights = *m_lights;
+		uint32 lightCount = (uint32)std::min<size_t>(lights.size(), MAX_LIGHTS);
+		m_lightData.resize(std::max<uint32>(lightCount, 1) * 8);
+		for(uint32 i = 0; i < lightCount; i++)
+		{
+			float* data = &m_lightData[i * 8];
+			data[0] = lights[i].pos.x * m_pixelScale;
+			data[1] = lights[i].pos.y * m_pixelScale;
+			data[2] = lights[i].radius * m_pixelScale;
+			data[3] = 0.0f;
+			data[4] = lights[i].color.x;
+			data[5] = lights[i].color.y;
+			data[6] = lights[i].color.z;
+			data[7] = lights[i].intensity;
+		}
+
+		m_stats.lights = lightCount;
+		m_stats.tiles = tileCount;
+		m_stats.maxLightsPerTile = maxLights;
+		m_stats.overflowedTiles = m_overflowedTiles;
+		m_stats.lightIndices = totalIndices;
+		m_stats.averageLightsPerTile = tileCount ? (float)totalIndices / tileCount : 0.0f;
+	}
+
+	void TiledLightCuller::cull(const std::vector<PointLight>& lights)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		m_tilesX = (m_viewportWidth + m_tileSize - 1) / m_tileSize;
+		m_tilesY = (m_viewportHeight + m_tileSize - 1) / m_tileSize;
+		m_tileSlots.resize(m_tilesX * m_tilesY * m_maxLightsPerTile);
+		m_tileCounts.resize(m_tilesX * m_tilesY);
+		m_lights = &lights;
+		m_overflowedTiles = 0;
+		m_nextRow = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_generation++;
+			m_activeWorkers = (uint32)m_workers.size();
+		}
+		m_workAvailable.notify_all();
+
+		// the calling thread bins rows as well
+		binRows();
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_workDone.wait(lock, [this]() { return m_activeWorkers == 0; });
+		}
+
+		compact();
+		m_lights = nullptr;
+
+		std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		m_stats.cullMs = elapsed.count();
+	}
+
+	void TiledLightCuller::upload()
+	{
+		if(m_tileHeaders.empty())
+			return;
+
+		if(m_lightTexture == 0)
+		{
+			createDataTexture(m_lightTexture);
+			createDataTexture(m_tileTexture);
+			createDataTexture(m_indexTexture);
+		}
+
+		uint32 lightRows = (uint32)m_lightData.size() / 8;
+		glBindTexture(GL_TEXTURE_2D, m_lightTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 2, lightRows, 0, GL_RGBA, GL_FLOAT, m_lightData.data());
+
+		glBindTexture(GL_TEXTURE_2D, m_tileTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, m_tilesX, m_tilesY, 0, GL_RG_INTEGER, GL_UNSIGNED_INT, m_tileHeaders.data());
+
+		uint32 indexRows = (uint32)m_lightIndices.size() / INDEX_TEXTURE_WIDTH;
+		glBindTexture(GL_TEXTURE_2D, m_indexTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, INDEX_TEXTURE_WIDTH, indexRows, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, m_lightIndices.data());
+	}
+
+	void TiledLightCuller::bind(GLuint program)
+	{
+		glActiveTexture(GL_TEXTURE2);
+		glBindTexture(GL_TEXTURE_2D, m_lightTexture);
+		glActiveTexture(GL_TEXTURE3);
+		glBindTexture(GL_TEXTURE_2D, m_tileTexture);
+		glActiveTexture(GL_TEXTURE4);
+		glBindTexture(GL_TEXTURE_2D, m_indexTexture);
+		glActiveTexture(GL_TEXTURE0);
+
+		glUniform1i(glGetUniformLocation(program, "lightData"), 2);
+		glUniform1i(glGetUniformLocation(program, "tileHeaders"), 3);
+		glUniform1i(glGetUniformLocation(program, "lightIndices"), 4);
+		glUniform1i(glGetUniformLocation(program, "tileSize"), m_tileSize);
+		glUniform2i(glGetUniformLocation(program, "tileCount"), m_tilesX, m_tilesY);
+		glUniform1i(glGetUniformLocation(program, "indexTextureWidth"), INDEX_TEXTURE_WIDTH);
+		glUniform1f(glGetUniformLocation(program, "targetHeight"), (float)m_viewportHeight);
+		glUniform1f(glGetUniformLocation(program, "lightHeight"), m_lightHeight * m_pixelScale);
+		glUniform3f(glGetUniformLocation(program, "ambient"), m_ambient.x, m_ambient.y, m_ambient.z);
+	}
+}
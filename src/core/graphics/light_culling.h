@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glad/glad.h>
+#include "core/common.h"
+
+namespace Dawn
+{
+	struct PointLight
+	{
+		// screen space, y down like the sprites
+		glm::vec2 pos;
+		float radius;
+		glm::vec3 color;
+		float intensity;
+	};
+
+	struct LightCullingStats
+	{
+		uint32 lights{};
+		uint32 tiles{};
+		uint32 lightIndices{};
+		uint32 maxLightsPerTile{};
+		uint32 overflowedTiles{};
+		float averageLightsPerTile{};
+		float cullMs{};
+	};
+
+	// Bins point lights into screen tiles on the CPU, in parallel over tile
+	// rows, and publishes the per-tile light lists as textures so the lit
+	// SpriteBatch shader can shade every sprite in a single pass.
+	class TiledLightCuller
+	{
+		uint32 m_tileSize{32};
+		uint32 m_viewportWidth{800};
+		uint32 m_viewportHeight{600};
+		uint32 m_tilesX{};
+		uint32 m_tilesY{};
+		uint32 m_maxLightsPerTile{64};
+		float m_pixelScale{1.0f};
+
+		glm::vec3 m_ambient{0.1f, 0.1f, 0.1f};
+		float m_lightHeight{48.0f};
+
+		const std::vector<PointLight>* m_lights{};
+		// fixed size slots per tile, written by the binning workers
+		std::vector<uint16> m_tileSlots{};
+		std::vector<uint16> m_tileCounts{};
+		std::atomic<uint32> m_overflowedTiles{};
+
+		// compacted data uploaded to the textures
+		std::vector<uint32> m_tileHeaders{};
+		std::vector<uint32> m_lightIndices{};
+		std::vector<float> m_lightData{};
+
+		std::vector<std::thread> m_workers{};
+		std::mutex m_mutex{};
+		std::condition_variable m_workAvailable{};
+		std::condition_variable m_workDone{};
+		std::atomic<uint32> m_nextRow{};
+		uint32 m_generation{};
+		uint32 m_activeWorkers{};
+		bool m_isRunning{};
+
+		GLuint m_lightTexture{};
+		GLuint m_tileTexture{};
+		GLuint m_indexTexture{};
+
+		LightCullingStats m_stats{};
+
+		void workerLoop();
+		void binRows();
+		void binRow(uint32 row);
+		void compact();
+
+		DAWN_NULL_COPY_AND_ASSIGN(TiledLightCuller)
+	public:
+		static const uint32 MAX_LIGHTS = 2048;
+		// the index texture wraps light indices into rows of this width
+		static const uint32 INDEX_TEXTURE_WIDTH = 1024;
+
+		TiledLightCuller() {}
+		~TiledLightCuller();
+
+		// workerCount threads help the calling thread with the binning.
+		void init(uint32 workerCount);
+		void shutdown();
+
+		// Size of the render target the lit sprites are drawn into, tiles are
+		// cut in its pixels.
+		void setViewport(uint32 width, uint32 height);
+		// Render target pixels per sprite unit, below 1 while dynamic
+		// resolution draws the scene at a reduced scale.
+		inline void setPixelScale(float scale) { m_pixelScale = scale; }
+		inline void setTileSize(uint32 tileSize) { m_tileSize = tileSize; }
+		inline void setMaxLightsPerTile(uint32 count) { m_maxLightsPerTile = count; }
+		inline void setAmbient(const glm::vec3& ambient) { m_ambient = ambient; }
+		// height of the lights above the sprite plane, in pixels
+		inline void setLightHeight(float height) { m_lightHeight = height; }
+
+		// CPU only, may run on any thread. The lights must outlive the call.
+		void cull(const std::vector<PointLight>& lights);
+		// GL thread, uploads the result of the last cull().
+		void upload();
+		// Binds the light textures to units 2-4 and sets the lit shader uniforms.
+		void bind(GLuint program);
+
+		inline const LightCullingStats& getStats() const { return m_stats; }
+	};
+}
@@ -0,0 +1,183 @@
+#include "overdraw_heatmap.h"
+#include "shader.h"
+
+namespace Dawn
+{
+	namespace
+	{
+		// fullscreen triangle generated from gl_VertexID, no vertex buffer needed
+		const GLchar* presentVertexShaderSource = {
+		R"(
+			#version 300 es
+
+			out vec2 uv;
+
+			void main()
+			{
+				uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+				gl_Position = vec4(uv * 2.0f - 1.0f, 0.0f, 1.0f);
+			}
+		)"
+		};
+
+		const GLchar* presentFragmentShaderSource = {
+		R"(
+			#version 300 es
+
+			precision mediump float;
+
+			out vec4 color;
+			in vec2 uv;
+
+			uniform sampler2D counts;
+			uniform float maxOverdraw;
+
+			void main()
+			{
+				float overdraw = texture(counts, uv).r * 255.0f;
+				float t = clamp(overdraw / maxOverdraw, 0.0f, 1.0f) * 4.0f;
+
+				// black -> blue -> green -> yellow -> red
+				vec3 ramp[5] = vec3[5](vec3(0.0f), vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 0.0f),
+				                       vec3(1.0f, 1.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f));
+				int index = int(min(t, 3.0f));
+				color = vec4(mix(ramp[index], ramp[index + 1], t - float(index)), 1.0f);
+			}
+		)"
+		};
+	}
+
+	OverdrawHeatmap& OverdrawHeatmap::getOverdrawHeatmap()
+	{
+		static OverdrawHeatmap overdrawHeatmap;
+		return overdrawHeatmap;
+	}
+
+	OverdrawHeatmap::OverdrawHeatmap()
+	{
+		EventDispatcher::getEventDispatcher().addEventListener(this, Event::KEY_DOWN);
+	}
+
+	OverdrawHeatmap::~OverdrawHeatmap()
+	{
+		EventDispatcher::getEventDispatcher().removeEventListener(this);
+	}
+
+	void OverdrawHeatmap::onKeyDown(KeyDownEvent& keyDownEvent)
+	{
+		if(keyDownEvent.getKeyCode() != m_toggleKey || keyDownEvent.isKeyRepeat())
+			return;
+
+		m_isEnabled = !m_isEnabled;
+		DAWN_INTERNAL_INFO("Overdraw heatmap {}", m_isEnabled ? "enabled" : "disabled");
+	}
+
+	void OverdrawHeatmap::resizeTarget(uint32 width, uint32 height)
+	{
+		if(m_framebuffer == 0)
+		{
+			glGenFramebuffers(1, &m_framebuffer);
+			glGenTextures(1, &m_countTexture);
+			glGenRenderbuffers(1, &m_depthBuffer);
+		}
+
+		glBindTexture(GL_TEXTURE_2D, m_countTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		// keeps early-z rejection visible in the counts when depth sorting is on
+		glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_countTexture, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		DAWN_INTERNAL_ASSERT(status == GL_FRAMEBUFFER_COMPLETE, "Overdraw heatmap target incomplete");
+
+		m_width = width;
+		m_height = height;
+	}
+
+	void OverdrawHeatmap::bindTarget(uint32 width, uint32 height)
+	{
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+		glGetIntegerv(GL_VIEWPORT, m_previousViewport);
+
+		if(width != m_width || height != m_height)
+			resizeTarget(width, height);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glViewport(0, 0, width, height);
+
+		// first flush of the frame starts from zero
+		if(!m_isCleared)
+		{
+			glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			m_isCleared = true;
+		}
+
+		glBlendFunc(GL_ONE, GL_ONE);
+	}
+
+	void OverdrawHeatmap::unbindTarget()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, m_previousFramebuffer);
+		glViewport(m_previousViewport[0], m_previousViewport[1], m_previousViewport[2], m_previousViewport[3]);
+	}
+
+	void OverdrawHeatmap::computeAverage()
+	{
+		m_readback.resize(m_width * m_height * 4);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, m_readback.data());
+
+		uint64 fragments = 0;
+		for(uint32 i = 0; i < m_width * m_height; i++)
+			fragments += m_readback[i * 4];
+
+		m_averageOverdraw = (float)fragments / (m_width * m_height);
+		DAWN_INTERNAL_INFO("Average overdraw {:.2f} ({} fragments over {}x{})", m_averageOverdraw, fragments, m_width, m_height);
+	}
+
+	void OverdrawHeatmap::present()
+	{
+		if(!m_isEnabled || !m_isCleared)
+			return;
+
+		GLint framebuffer = 0;
+		glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+
+		if(m_readbackInterval > 0 && m_frame++ % m_readbackInterval == 0)
+			computeAverage();
+
+		if(m_presentProgram == 0)
+		{
+			glGenVertexArrays(1, &m_vertexArray);
+			m_presentProgram = createShaderProgram(presentVertexShaderSource, presentFragmentShaderSource);
+			m_maxOverdrawLocation = glGetUniformLocation(m_presentProgram, "maxOverdraw");
+
+			glUseProgram(m_presentProgram);
+			glUniform1i(glGetUniformLocation(m_presentProgram, "counts"), 0);
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glDisable(GL_DEPTH_TEST);
+		glDisable(GL_BLEND);
+
+		glUseProgram(m_presentProgram);
+		glUniform1f(m_maxOverdrawLocation, m_maxOverdraw);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, m_countTexture);
+		glBindVertexArray(m_vertexArray);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+
+		m_isCleared = false;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <glad/glad.h>
+#include "core/common.h"
+#include "core/input.h"
+#include "core/events/events.h"
+
+namespace Dawn
+{
+	// Debug mode that replaces the sprite shader with a constant additive one,
+	// accumulating shaded fragments per pixel in an offscreen target. present()
+	// draws the counts through a colour ramp and periodically reads them back
+	// to report the average overdraw. Toggled at runtime with the toggle key.
+	class OverdrawHeatmap : public EventListener
+	{
+		OverdrawHeatmap();
+		~OverdrawHeatmap();
+
+		bool m_isEnabled{};
+		uint32 m_toggleKey{Input::KEY_F3};
+
+		GLuint m_framebuffer{};
+		GLuint m_countTexture{};
+		GLuint m_depthBuffer{};
+		uint32 m_width{};
+		uint32 m_height{};
+		GLint m_previousFramebuffer{};
+		GLint m_previousViewport[4]{};
+		bool m_isCleared{};
+
+		GLuint m_vertexArray{};
+		GLuint m_presentProgram{};
+		GLint m_maxOverdrawLocation{-1};
+		float m_maxOverdraw{8.0f};
+
+		uint32 m_frame{};
+		uint32 m_readbackInterval{60};
+		std::vector<uint8> m_readback{};
+		float m_averageOverdraw{};
+
+		void resizeTarget(uint32 width, uint32 height);
+		void computeAverage();
+
+		DAWN_NULL_COPY_AND_ASSIGN(OverdrawHeatmap)
+	public:
+		static OverdrawHeatmap& getOverdrawHeatmap();
+
+		inline bool isEnabled() const { return m_isEnabled; }
+		inline void setEnabled(bool isEnabled) { m_isEnabled = isEnabled; }
+		inline void setToggleKey(uint32 keyCode) { m_toggleKey = keyCode; }
+		// Overdraw mapped to the hot end of the colour ramp.
+		inline void setMaxOverdraw(float maxOverdraw) { m_maxOverdraw = maxOverdraw; }
+		inline void setReadbackInterval(uint32 frames) { m_readbackInterval = frames; }
+		inline float getAverageOverdraw() const { return m_averageOverdraw; }
+
+		// Used by SpriteBatch::flush() while enabled.
+		void bindTarget(uint32 width, uint32 height);
+		void unbindTarget();
+
+		// Draws the heatmap into the bound framebuffer, call once per frame before the swap.
+		void present();
+
+		void onKeyDown(KeyDownEvent& keyDownEvent) override;
+	};
+}
@@ -0,0 +1,61 @@
+#include "shader.h"
+#include "core/log.h"
+
+namespace Dawn
+{
+	namespace
+	{
+		GLuint compileShader(GLenum type, const GLchar* source)
+		{
+			GLuint shader = glCreateShader(type);
+			glShaderSource(shader, 1, &source, nullptr);
+			glCompileShader(shader);
+
+			GLint success = 0;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+			if(!success)
+			{
+				GLchar log[512];
+				glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+				DAWN_INTERNAL_ERROR("Shader compilation failed: {}", log);
+				glDeleteShader(shader);
+				return 0;
+			}
+
+			return shader;
+		}
+	}
+
+	GLuint createShaderProgram(const GLchar* vertexShaderSource, const GLchar* fragmentShaderSource)
+	{
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource);
+		GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+		if(vertexShader == 0 || fragmentShader == 0)
+		{
+			glDeleteShader(vertexShader);
+			glDeleteShader(fragmentShader);
+			return 0;
+		}
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint success = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if(!success)
+		{
+			GLchar log[512];
+			glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+			DAWN_INTERNAL_ERROR("Shader program link failed: {}", log);
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		return program;
+	}
+}
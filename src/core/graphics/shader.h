@@ -0,0 +1,10 @@
+#pragma once
+
+#include <glad/glad.h>
+
+namespace Dawn
+{
+	// Compiles and links a vertex/fragment pair, logging compiler output on
+	// failure. Returns 0 if either stage or the link fails.
+	GLuint createShaderProgram(const GLchar* vertexShaderSource, const GLchar* fragmentShaderSource);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "core/common.h"
+
+namespace Dawn
+{
+	inline GLenum getSizedTextureFormat(uint32 channels)
+	{
+		switch(channels)
+		{
+			case 1: return GL_R8;
+			case 2: return GL_RG8;
+			case 3: return GL_RGB8;
+			default: return GL_RGBA8;
+		}
+	}
+
+	inline GLenum getPixelFormat(uint32 channels)
+	{
+		switch(channels)
+		{
+			case 1: return GL_RED;
+			case 2: return GL_RG;
+			case 3: return GL_RGB;
+			default: return GL_RGBA;
+		}
+	}
+}
@@ -0,0 +1,413 @@
+#include "texture_manager.h"
+#include <stb_image.h>
+#include "texture_format.h"
+#include "compressed_texture.h"
+
+namespace Dawn
+{
+	namespace
+	{
+		const uint64 DEFAULT_BUDGET_BYTES = 64 * 1024 * 1024;
+		const uint32 UPLOAD_WORKER_COUNT = 2;
+	}
+
+	TextureManager& TextureManager::getTextureManager()
+	{
+		static TextureManager textureManager;
+		return textureManager;
+	}
+
+	TextureManager::TextureManager()
+	{
+		m_stats.budgetBytes = DEFAULT_BUDGET_BYTES;
+	}
+
+	void TextureManager::clear()
+	{
+		if(m_isUploadQueueRunning)
+		{
+			m_uploadQueue.shutdown();
+			m_isUploadQueueRunning = false;
+
+			// the queue dropped these, release the slots destroy() held back
+			for(uint32 slot = 1; slot < m_textures.size(); slot++)
+			{
+				if(m_textures[slot].isPending)
+				{
+					m_textures[slot].isPending = false;
+					if(!m_textures[slot].isAlive)
+						releaseSlot(slot);
+				}
+			}
+		}
+
+		for(uint32 slot = 1; slot < m_textures.size(); slot++)
+		{
+			if(m_textures[slot].isAlive)
+				destroy(makeHandle(slot));
+		}
+	}
+
+	uint32 TextureManager::findSlot(TextureHandle handle) const
+	{
+		uint32 slot = handle & SLOT_MASK;
+		if(slot == 0 || slot >= m_textures.size())
+			return 0;
+
+		const TextureEntry& entry = m_textures[slot];
+		if(entry.generation != handle >> SLOT_BITS || !entry.isAlive)
+			return 0;
+
+		return slot;
+	}
+
+	uint32 TextureManager::allocateSlot()
+	{
+		// slot 0 is reserved for INVALID_HANDLE
+		if(m_textures.empty())
+			m_textures.emplace_back();
+
+		if(!m_freeSlots.empty())
+		{
+			uint32 slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+			return slot;
+		}
+
+		if(m_textures.size() > SLOT_MASK)
+		{
+			DAWN_INTERNAL_ERROR("Out of texture handles, {} textures exist", (uint32)SLOT_MASK);
+			return 0;
+		}
+
+		m_textures.emplace_back();
+		return (uint32)(m_textures.size() - 1);
+	}
+
+	void TextureManager::releaseSlot(uint32 slot)
+	{
+		uint16 generation = m_textures[slot].generation;
+		m_textures[slot] = TextureEntry();
+		m_textures[slot].generation = generation + 1;
+		m_freeSlots.push_back(slot);
+	}
+
+	TextureHandle TextureManager::load(const std::string& path)
+	{
+		CompressedTextureHeader header;
+		if(readCompressedTextureHeader(path, header))
+		{
+			uint32 slot = allocateSlot();
+			if(slot == 0)
+				return INVALID_HANDLE;
+
+			TextureEntry& entry = m_textures[slot];
+			entry.width = header.width;
+			entry.height = header.height;
+			entry.path = path;
+			entry.isCompressed = true;
+			entry.isAlive = true;
+
+			uint32 width = header.width;
+			uint32 height = header.height;
+			for(uint32 i = 0; i < header.mipCount; i++)
+			{
+				entry.sizeInBytes += getCompressedMipSize(header.format, width, height);
+				width = width > 1 ? width / 2 : 1;
+				height = height > 1 ? height / 2 : 1;
+			}
+
+			m_stats.totalCount++;
+			return makeHandle(slot);
+		}
+
+		int x, y, n;
+		if(!stbi_info(path.c_str(), &x, &y, &n))
+		{
+			DAWN_INTERNAL_ERROR("Couldn't read texture {}: {}", path, stbi_failure_reason());
+			return INVALID_HANDLE;
+		}
+
+		uint32 slot = allocateSlot();
+		if(slot == 0)
+			return INVALID_HANDLE;
+
+		TextureEntry& entry = m_textures[slot];
+		entry.width = x;
+		entry.height = y;
+		entry.channels = n;
+		entry.sizeInBytes = (uint64)x * y * n;
+		entry.path = path;
+		entry.isAlive = true;
+
+		m_stats.totalCount++;
+		return makeHandle(slot);
+	}
+
+	TextureHandle TextureManager::create(const uint8* pixels, uint32 width, uint32 height, uint32 channels)
+	{
+		DAWN_INTERNAL_ASSERT(pixels != nullptr, "Texture created without pixels");
+
+		uint32 slot = allocateSlot();
+		if(slot == 0)
+			return INVALID_HANDLE;
+
+		TextureEntry& entry = m_textures[slot];
+		entry.width = width;
+		entry.height = height;
+		entry.channels = channels;
+		entry.sizeInBytes = (uint64)width * height * channels;
+		entry.pixels.assign(pixels, pixels + entry.sizeInBytes);
+		entry.isAlive = true;
+
+		m_stats.totalCount++;
+		return makeHandle(slot);
+	}
+
+	TextureHandle TextureManager::loadAsync(const std::string& path)
+	{
+		TextureHandle handle = load(path);
+		if(handle == INVALID_HANDLE)
+			return INVALID_HANDLE;
+
+		if(!m_isUploadQueueRunning)
+		{
+			m_uploadQueue.init(UPLOAD_WORKER_COUNT);
+			m_isUploadQueueRunning = true;
+		}
+
+		uint32 slot = handle & SLOT_MASK;
+		TextureEntry& entry = m_textures[slot];
+		// compressed data is already upload sized, it goes through acquire()
+		if(entry.isCompressed)
+			return handle;
+
+		// tagged with the slot, which stays taken until the upload comes back
+		entry.isPending = true;
+		m_uploadQueue.enqueue(slot, path, entry.width, entry.height, entry.channels);
+		return handle;
+	}
+
+	void TextureManager::destroy(TextureHandle handle)
+	{
+		uint32 slot = findSlot(handle);
+		if(slot == 0)
+			return;
+
+		// the slot is recycled once the upload queue hands the texture back
+		if(m_textures[slot].isPending)
+		{
+			m_textures[slot].isAlive = false;
+			m_stats.totalCount--;
+			return;
+		}
+
+		if(m_textures[slot].isResident)
+			evict(slot);
+
+		releaseSlot(slot);
+		m_stats.totalCount--;
+	}
+
+	void TextureManager::upload(uint32 slot, const uint8* pixels)
+	{
+		TextureEntry& entry = m_textures[slot];
+
+		glGenTextures(1, &entry.glTexture);
+		glBindTexture(GL_TEXTURE_2D, entry.glTexture);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, getSizedTextureFormat(entry.channels), entry.width, entry.height, 0,
+		             getPixelFormat(entry.channels), GL_UNSIGNED_BYTE, pixels);
+
+		makeResident(slot, entry.glTexture);
+	}
+
+	bool TextureManager::uploadCompressed(uint32 slot)
+	{
+		TextureEntry& entry = m_textures[slot];
+
+		CompressedTexture texture;
+		if(!readCompressedTexture(entry.path, texture))
+		{
+			DAWN_INTERNAL_ERROR("Couldn't load compressed texture {}", entry.path);
+			return false;
+		}
+
+		const CompressedTextureHeader& header = texture.header;
+		GLenum format = header.format == ETC2_RGBA8_EAC ? GL_COMPRESSED_RGBA8_ETC2_EAC : GL_COMPRESSED_RGB8_ETC2;
+
+		glGenTextures(1, &entry.glTexture);
+		glBindTexture(GL_TEXTURE_2D, entry.glTexture);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, header.mipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header.mipCount - 1);
+
+		uint32 width = header.width;
+		uint32 height = header.height;
+		for(uint32 level = 0; level < header.mipCount; level++)
+		{
+			glCompressedTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0,
+			                       (GLsizei)texture.mips[level].size(), texture.mips[level].data());
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+
+		makeResident(slot, entry.glTexture);
+		return true;
+	}
+
+	void TextureManager::makeResident(uint32 slot, GLuint glTexture)
+	{
+		TextureEntry& entry = m_textures[slot];
+
+		entry.glTexture = glTexture;
+		entry.isResident = true;
+		entry.lruNode = m_lru.insert(m_lru.end(), slot);
+
+		m_stats.residentBytes += entry.sizeInBytes;
+		m_stats.residentCount++;
+		if(entry.wasUploaded)
+			m_stats.reuploads++;
+		else
+			m_stats.uploads++;
+		entry.wasUploaded = true;
+	}
+
+	GLuint TextureManager::acquire(TextureHandle handle)
+	{
+		uint32 slot = findSlot(handle);
+		if(slot == 0)
+			return 0;
+
+		TextureEntry& entry = m_textures[slot];
+		if(entry.isPending)
+			return 0;
+
+		entry.lastUsedFrame = m_frame;
+
+		if(entry.isResident)
+		{
+			m_lru.splice(m_lru.end(), m_lru, entry.lruNode);
+			return entry.glTexture;
+		}
+
+		if(entry.isCompressed)
+		{
+			if(!uploadCompressed(slot))
+				return 0;
+		}
+		else if(entry.path.empty())
+		{
+			upload(slot, entry.pixels.data());
+		}
+		else
+		{
+			int x, y, n;
+			stbi_uc* pixels = stbi_load(entry.path.c_str(), &x, &y, &n, entry.channels);
+			if(pixels == nullptr)
+			{
+				DAWN_INTERNAL_ERROR("Couldn't load texture {}: {}", entry.path, stbi_failure_reason());
+				return 0;
+			}
+
+			upload(slot, pixels);
+			stbi_image_free(pixels);
+		}
+
+		enforceBudget(slot);
+		return entry.glTexture;
+	}
+
+	bool TextureManager::isOpaque(TextureHandle handle) const
+	{
+		uint32 slot = findSlot(handle);
+		if(slot == 0)
+			return false;
+
+		const TextureEntry& entry = m_textures[slot];
+		if(entry.isCompressed)
+		{
+			CompressedTextureHeader header;
+			return readCompressedTextureHeader(entry.path, header) && header.format == ETC2_RGB8;
+		}
+
+		return entry.channels == 1 || entry.channels == 3;
+	}
+
+	void TextureManager::evict(uint32 slot)
+	{
+		TextureEntry& entry = m_textures[slot];
+
+		glDeleteTextures(1, &entry.glTexture);
+		entry.glTexture = 0;
+		entry.isResident = false;
+		m_lru.erase(entry.lruNode);
+
+		m_stats.residentBytes -= entry.sizeInBytes;
+		m_stats.residentCount--;
+	}
+
+	void TextureManager::enforceBudget(uint32 keep)
+	{
+		auto it = m_lru.begin();
+		while(m_stats.residentBytes > m_stats.budgetBytes && it != m_lru.end())
+		{
+			uint32 slot = *it++;
+			if(slot == keep || m_textures[slot].lastUsedFrame == m_frame)
+				continue;
+
+			evict(slot);
+			m_stats.evictions++;
+		}
+	}
+
+	void TextureManager::processCompletedUploads()
+	{
+		m_completedUploads.clear();
+		m_uploadQueue.update(m_completedUploads);
+
+		for(auto& upload : m_completedUploads)
+		{
+			TextureEntry& entry = m_textures[upload.tag];
+			entry.isPending = false;
+
+			if(!entry.isAlive)
+			{
+				glDeleteTextures(1, &upload.texture);
+				releaseSlot(upload.tag);
+				continue;
+			}
+
+			// a failed background upload falls back to a synchronous one on acquire
+			if(upload.texture != 0)
+				makeResident(upload.tag, upload.texture);
+		}
+	}
+
+	void TextureManager::beginFrame()
+	{
+		if(m_isUploadQueueRunning)
+			processCompletedUploads();
+
+		if(m_stats.residentBytes > m_stats.budgetBytes)
+			m_stats.overBudgetFrames++;
+
+		m_frame++;
+		enforceBudget(0);
+	}
+
+	void TextureManager::setBudget(uint64 budgetBytes)
+	{
+		m_stats.budgetBytes = budgetBytes;
+		enforceBudget(0);
+	}
+}
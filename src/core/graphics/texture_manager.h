@@ -0,0 +1,123 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include "core/common.h"
+#include "texture_upload_queue.h"
+
+namespace Dawn
+{
+	// generation in the high 16 bits, slot index in the low 16 bits, 0 is never
+	// issued; 32 bits so sprites can carry a handle in place of a GL texture
+	typedef uint32 TextureHandle;
+
+	struct TextureStats
+	{
+		uint64 budgetBytes{};
+		uint64 residentBytes{};
+		uint32 residentCount{};
+		uint32 totalCount{};
+
+		uint32 uploads{};
+		uint32 reuploads{};
+		uint32 evictions{};
+		uint32 overBudgetFrames{};
+	};
+
+	class TextureManager
+	{
+		struct TextureEntry
+		{
+			GLuint glTexture{};
+			uint32 width{};
+			uint32 height{};
+			uint32 channels{};
+			uint64 sizeInBytes{};
+			uint32 lastUsedFrame{};
+			// bumped whenever the slot is recycled, so stale handles stop matching
+			uint16 generation{1};
+			bool isResident{};
+			bool isAlive{};
+			bool wasUploaded{};
+			bool isPending{};
+			bool isCompressed{};
+
+			// source used to re-upload after an eviction
+			std::string path{};
+			std::vector<uint8> pixels{};
+
+			std::list<uint32>::iterator lruNode{};
+		};
+
+		static const uint32 SLOT_BITS = 16;
+		static const uint32 SLOT_MASK = (1u << SLOT_BITS) - 1;
+
+		TextureManager();
+		~TextureManager() {}
+
+		std::vector<TextureEntry> m_textures{};
+		std::vector<uint32> m_freeSlots{};
+		// slots, least recently used at the front, only holds resident textures
+		std::list<uint32> m_lru{};
+
+		TextureStats m_stats{};
+		uint32 m_frame{1};
+
+		TextureUploadQueue m_uploadQueue{};
+		std::vector<CompletedUpload> m_completedUploads{};
+		bool m_isUploadQueueRunning{};
+
+		inline TextureHandle makeHandle(uint32 slot) const { return (uint32)m_textures[slot].generation << SLOT_BITS | slot; }
+		// Slot of a live texture, 0 for stale or invalid handles.
+		uint32 findSlot(TextureHandle handle) const;
+
+		// 0 once all SLOT_MASK slots are taken
+		uint32 allocateSlot();
+		void releaseSlot(uint32 slot);
+		void upload(uint32 slot, const uint8* pixels);
+		bool uploadCompressed(uint32 slot);
+		void makeResident(uint32 slot, GLuint glTexture);
+		void processCompletedUploads();
+		void evict(uint32 slot);
+		// 0 keeps nothing but this frame's textures
+		void enforceBudget(uint32 keep);
+
+		DAWN_NULL_COPY_AND_ASSIGN(TextureManager)
+	public:
+		static const TextureHandle INVALID_HANDLE = 0;
+
+		static TextureManager& getTextureManager();
+
+		// Textures loaded from disk are re-read from the file after eviction,
+		// textures created from memory keep a CPU copy for re-upload.
+		// .dtex files produced by texconv are uploaded as compressed ETC2.
+		TextureHandle load(const std::string& path);
+		TextureHandle create(const uint8* pixels, uint32 width, uint32 height, uint32 channels);
+		// Decodes and uploads in the background, acquire() returns 0 until
+		// the upload queue has finished with the texture.
+		TextureHandle loadAsync(const std::string& path);
+		// The handle and any copy of it are invalid afterwards, even once
+		// the slot is reused.
+		void destroy(TextureHandle handle);
+		// Must be called while the GL context is still alive.
+		void clear();
+
+		// Makes the texture resident and marks it as used this frame.
+		// Textures used in the current frame are never evicted.
+		GLuint acquire(TextureHandle handle);
+
+		// True for formats without an alpha channel, such textures can go
+		// through SpriteBatch's opaque pass.
+		bool isOpaque(TextureHandle handle) const;
+
+		// Also drives the upload queue, so it has to run on the GL thread.
+		void beginFrame();
+
+		void setBudget(uint64 budgetBytes);
+		inline uint64 getBudget() const { return m_stats.budgetBytes; }
+		inline const TextureStats& getStats() const { return m_stats; }
+		inline TextureUploadQueue& getUploadQueue() { return m_uploadQueue; }
+	};
+}
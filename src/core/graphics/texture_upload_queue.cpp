@@ -0,0 +1,315 @@
+#include "texture_upload_queue.h"
+#include <chrono>
+#include <cstring>
+#include <stb_image.h>
+#include "texture_format.h"
+
+namespace Dawn
+{
+	TextureUploadQueue::~TextureUploadQueue()
+	{
+		if(m_isRunning)
+		{
+			DAWN_INTERNAL_WARN("TextureUploadQueue destroyed without shutdown(), GL resources are leaked");
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_isRunning = false;
+			}
+			m_workAvailable.notify_all();
+
+			for(auto& worker : m_workers)
+				worker.join();
+		}
+	}
+
+	void TextureUploadQueue::init(uint32 workerCount)
+	{
+		DAWN_INTERNAL_ASSERT(!m_isRunning, "TextureUploadQueue initialized twice");
+
+		m_isRunning = true;
+		for(uint32 i = 0; i < workerCount; i++)
+			m_workers.emplace_back(&TextureUploadQueue::workerLoop, this);
+	}
+
+	void TextureUploadQueue::shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isRunning = false;
+		}
+		m_workAvailable.notify_all();
+
+		for(auto& worker : m_workers)
+			worker.join();
+		m_workers.clear();
+
+		for(auto job : m_jobs)
+		{
+			if(job->fence)
+				glDeleteSync(job->fence);
+			if(job->texture)
+				glDeleteTextures(1, &job->texture);
+			delete job;
+		}
+		m_jobs.clear();
+		m_copyQueue.clear();
+		m_pending.clear();
+
+		for(auto& staging : m_staging)
+		{
+			if(staging.mapped)
+			{
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.pbo);
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			}
+			glDeleteBuffers(1, &staging.pbo);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		m_staging.clear();
+
+		m_stats = TextureUploadStats();
+	}
+
+	void TextureUploadQueue::enqueue(uint32 tag, const std::string& path, uint32 width, uint32 height, uint32 channels)
+	{
+		UploadJob* job = new UploadJob;
+		job->tag = tag;
+		job->path = path;
+		job->width = width;
+		job->height = height;
+		job->channels = channels;
+		job->sizeInBytes = (uint64)width * height * channels;
+
+		m_jobs.push_back(job);
+		m_stats.queued++;
+	}
+
+	void TextureUploadQueue::enqueue(uint32 tag, const uint8* pixels, uint32 width, uint32 height, uint32 channels)
+	{
+		UploadJob* job = new UploadJob;
+		job->tag = tag;
+		job->width = width;
+		job->height = height;
+		job->channels = channels;
+		job->sizeInBytes = (uint64)width * height * channels;
+		job->pixels.assign(pixels, pixels + job->sizeInBytes);
+
+		m_jobs.push_back(job);
+		m_stats.queued++;
+	}
+
+	void TextureUploadQueue::workerLoop()
+	{
+		while(true)
+		{
+			UploadJob* job = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_workAvailable.wait(lock, [this]() { return !m_isRunning || !m_copyQueue.empty(); });
+
+				if(!m_isRunning)
+					return;
+
+				job = m_copyQueue.front();
+				m_copyQueue.pop_front();
+			}
+
+			bool failed = false;
+			if(job->path.empty())
+			{
+				std::memcpy(job->destination, job->pixels.data(), job->sizeInBytes);
+				std::vector<uint8>().swap(job->pixels);
+			}
+			else
+			{
+				int x, y, n;
+				stbi_uc* pixels = stbi_load(job->path.c_str(), &x, &y, &n, job->channels);
+				if(pixels == nullptr || (uint32)x != job->width || (uint32)y != job->height)
+				{
+					DAWN_INTERNAL_ERROR("Couldn't decode texture {}", job->path);
+					failed = true;
+				}
+				else
+				{
+					std::memcpy(job->destination, pixels, job->sizeInBytes);
+				}
+				stbi_image_free(pixels);
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			job->failed = failed;
+			job->state = JobState::READY;
+		}
+	}
+
+	bool TextureUploadQueue::mapStaging(UploadJob& job)
+	{
+		int32 candidate = -1;
+		for(uint32 i = 0; i < m_staging.size(); i++)
+		{
+			if(m_staging[i].inUse)
+				continue;
+
+			// prefer a buffer that doesn't need to be reallocated
+			if(candidate < 0 || m_staging[i].capacity >= job.sizeInBytes)
+				candidate = i;
+			if(m_staging[i].capacity >= job.sizeInBytes)
+				break;
+		}
+
+		if(candidate < 0)
+		{
+			if(m_staging.size() >= m_maxStagingBuffers)
+				return false;
+
+			StagingBuffer staging;
+			glGenBuffers(1, &staging.pbo);
+			m_staging.push_back(staging);
+			candidate = (int32)m_staging.size() - 1;
+			m_stats.stagingBuffers++;
+		}
+
+		StagingBuffer& staging = m_staging[candidate];
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.pbo);
+		if(staging.capacity < job.sizeInBytes)
+		{
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, job.sizeInBytes, nullptr, GL_STREAM_DRAW);
+			staging.capacity = job.sizeInBytes;
+		}
+
+		staging.mapped = (uint8*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, job.sizeInBytes,
+		                                          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if(staging.mapped == nullptr)
+		{
+			DAWN_INTERNAL_ERROR("Couldn't map pixel unpack buffer ({} bytes)", job.sizeInBytes);
+			return false;
+		}
+
+		staging.inUse = true;
+		job.staging = candidate;
+		job.destination = staging.mapped;
+		return true;
+	}
+
+	void TextureUploadQueue::submit(UploadJob& job)
+	{
+		StagingBuffer& staging = m_staging[job.staging];
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging.pbo);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		staging.mapped = nullptr;
+		job.destination = nullptr;
+
+		if(!job.failed)
+		{
+			glGenTextures(1, &job.texture);
+			glBindTexture(GL_TEXTURE_2D, job.texture);
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexStorage2D(GL_TEXTURE_2D, 1, getSizedTextureFormat(job.channels), job.width, job.height);
+			// with an unpack buffer bound the pointer is an offset into it
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, job.width, job.height,
+			                getPixelFormat(job.channels), GL_UNSIGNED_BYTE, nullptr);
+
+			m_stats.bytesThisFrame += job.sizeInBytes;
+			m_stats.bytesUploaded += job.sizeInBytes;
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		job.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		job.state = JobState::IN_FLIGHT;
+		m_stats.inFlight++;
+	}
+
+	void TextureUploadQueue::update(std::vector<CompletedUpload>& completed)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		m_stats.bytesThisFrame = 0;
+
+		// Snapshot the worker owned states once, jobs that become ready
+		// meanwhile are picked up next frame.
+		m_states.clear();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for(auto job : m_jobs)
+				m_states.push_back(job->state);
+		}
+
+		bool isStagingExhausted = false;
+		bool isBudgetExhausted = false;
+		m_pending.clear();
+
+		for(uint32 i = 0; i < m_jobs.size(); i++)
+		{
+			UploadJob* job = m_jobs[i];
+
+			switch(m_states[i])
+			{
+				case JobState::IN_FLIGHT:
+				{
+					GLenum result = glClientWaitSync(job->fence, 0, 0);
+					if(result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+						break;
+
+					glDeleteSync(job->fence);
+					m_staging[job->staging].inUse = false;
+					completed.push_back({ job->tag, job->texture });
+
+					m_stats.inFlight--;
+					m_stats.queued--;
+					m_stats.completed++;
+					delete job;
+					continue;
+				}
+				case JobState::READY:
+				{
+					// always let one upload through so oversized textures can't stall the queue
+					uint64 bytes = m_stats.bytesThisFrame + job->sizeInBytes;
+					if(isBudgetExhausted || (m_stats.bytesThisFrame > 0 && bytes > m_frameBudgetBytes))
+					{
+						isBudgetExhausted = true;
+						break;
+					}
+
+					submit(*job);
+					break;
+				}
+				case JobState::WAITING_FOR_STAGING:
+				{
+					if(isStagingExhausted || !mapStaging(*job))
+					{
+						isStagingExhausted = true;
+						break;
+					}
+
+					{
+						std::lock_guard<std::mutex> lock(m_mutex);
+						job->state = JobState::COPYING;
+						m_copyQueue.push_back(job);
+					}
+					m_workAvailable.notify_one();
+					break;
+				}
+				case JobState::COPYING:
+					break;
+			}
+
+			m_pending.push_back(job);
+		}
+
+		m_jobs.swap(m_pending);
+
+		std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		m_stats.updateMs = elapsed.count();
+		if(m_stats.updateMs > m_stats.peakUpdateMs)
+			m_stats.peakUpdateMs = m_stats.updateMs;
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+#include "core/common.h"
+
+namespace Dawn
+{
+	struct CompletedUpload
+	{
+		uint32 tag;
+		GLuint texture;
+	};
+
+	struct TextureUploadStats
+	{
+		uint32 queued{};
+		uint32 inFlight{};
+		uint32 completed{};
+		uint32 stagingBuffers{};
+
+		uint64 bytesThisFrame{};
+		uint64 bytesUploaded{};
+		// CPU time spent in update(), to compare against synchronous glTexImage2D spikes
+		float updateMs{};
+		float peakUpdateMs{};
+	};
+
+	// Streams pixels to the GPU through GL_PIXEL_UNPACK_BUFFER staging buffers.
+	// Worker threads decode images and copy them into PBOs that were mapped on
+	// the GL thread; update() (GL thread only) then issues glTexSubImage2D from
+	// the PBOs within a per-frame byte budget and retires them through fences.
+	class TextureUploadQueue
+	{
+		enum class JobState
+		{
+			WAITING_FOR_STAGING,
+			COPYING,
+			READY,
+			IN_FLIGHT
+		};
+
+		struct StagingBuffer
+		{
+			GLuint pbo{};
+			uint64 capacity{};
+			uint8* mapped{};
+			bool inUse{};
+		};
+
+		struct UploadJob
+		{
+			uint32 tag{};
+			std::string path{};
+			std::vector<uint8> pixels{};
+			uint32 width{};
+			uint32 height{};
+			uint32 channels{};
+			uint64 sizeInBytes{};
+
+			JobState state{JobState::WAITING_FOR_STAGING};
+			uint32 staging{};
+			uint8* destination{};
+			GLuint texture{};
+			GLsync fence{};
+			bool failed{};
+		};
+
+		std::vector<std::thread> m_workers{};
+		std::mutex m_mutex{};
+		std::condition_variable m_workAvailable{};
+		bool m_isRunning{};
+
+		// owned by the GL thread, jobs only leave this list in update()
+		std::deque<UploadJob*> m_jobs{};
+		// jobs handed to the workers, guarded by m_mutex
+		std::deque<UploadJob*> m_copyQueue{};
+
+		// update() scratch, kept so a frame doesn't allocate
+		std::vector<JobState> m_states{};
+		std::deque<UploadJob*> m_pending{};
+
+		std::vector<StagingBuffer> m_staging{};
+		uint32 m_maxStagingBuffers{4};
+		uint64 m_frameBudgetBytes{4 * 1024 * 1024};
+
+		TextureUploadStats m_stats{};
+
+		void workerLoop();
+		bool mapStaging(UploadJob& job);
+		void submit(UploadJob& job);
+
+		DAWN_NULL_COPY_AND_ASSIGN(TextureUploadQueue)
+	public:
+		TextureUploadQueue() {}
+		~TextureUploadQueue();
+
+		void init(uint32 workerCount);
+		// Must be called on the GL thread while the context is still alive.
+		void shutdown();
+
+		// Enqueue from the GL thread, the tag is handed back on completion.
+		void enqueue(uint32 tag, const std::string& path, uint32 width, uint32 height, uint32 channels);
+		void enqueue(uint32 tag, const uint8* pixels, uint32 width, uint32 height, uint32 channels);
+
+		// GL thread only, appends uploads whose fence has signaled.
+		void update(std::vector<CompletedUpload>& completed);
+
+		inline void setFrameBudget(uint64 bytes) { m_frameBudgetBytes = bytes; }
+		inline void setMaxStagingBuffers(uint32 count) { m_maxStagingBuffers = count; }
+		inline const TextureUploadStats& getStats() const { return m_stats; }
+	};
+}
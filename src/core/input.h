@@ -1,5 +1,254 @@
 #pragma once 
 
+// Every key as X(name, code). The codes are SDL's scancodes, which follow
+// the USB HID usage tables. Both the Input enum and the names an ActionMap
+// binds by come from this list, so a key added here exists in both.
+#define DAWN_INPUT_KEYS(X) \
+	/* usage page 0x07, USB keyboard page */ \
+	X(KEY_A, 4) \
+	X(KEY_B, 5) \
+	X(KEY_C, 6) \
+	X(KEY_D, 7) \
+	X(KEY_E, 8) \
+	X(KEY_F, 9) \
+	X(KEY_G, 10) \
+	X(KEY_H, 11) \
+	X(KEY_I, 12) \
+	X(KEY_J, 13) \
+	X(KEY_K, 14) \
+	X(KEY_L, 15) \
+	X(KEY_M, 16) \
+	X(KEY_N, 17) \
+	X(KEY_O, 18) \
+	X(KEY_P, 19) \
+	X(KEY_Q, 20) \
+	X(KEY_R, 21) \
+	X(KEY_S, 22) \
+	X(KEY_T, 23) \
+	X(KEY_U, 24) \
+	X(KEY_V, 25) \
+	X(KEY_W, 26) \
+	X(KEY_X, 27) \
+	X(KEY_Y, 28) \
+	X(KEY_Z, 29) \
+	X(KEY_1, 30) \
+	X(KEY_2, 31) \
+	X(KEY_3, 32) \
+	X(KEY_4, 33) \
+	X(KEY_5, 34) \
+	X(KEY_6, 35) \
+	X(KEY_7, 36) \
+	X(KEY_8, 37) \
+	X(KEY_9, 38) \
+	X(KEY_0, 39) \
+	X(KEY_RETURN, 40) \
+	X(KEY_ESCAPE, 41) \
+	X(KEY_BACKSPACE, 42) \
+	X(KEY_TAB, 43) \
+	X(KEY_SPACE, 44) \
+	X(KEY_MINUS, 45) \
+	X(KEY_EQUALS, 46) \
+	X(KEY_LEFTBRACKET, 47) \
+	X(KEY_RIGHTBRACKET, 48) \
+	X(KEY_BACKSLASH, 49) /* lower left of return on ISO keyboards, right end of the QWERTY row on ANSI ones */ \
+	X(KEY_NONUSHASH, 50) /* ISO keyboards send it for the key of KEY_BACKSLASH, OSes treat both the same */ \
+	X(KEY_SEMICOLON, 51) \
+	X(KEY_APOSTROPHE, 52) \
+	X(KEY_GRAVE, 53) /* top left corner on both ANSI and ISO keyboards */ \
+	X(KEY_COMMA, 54) \
+	X(KEY_PERIOD, 55) \
+	X(KEY_SLASH, 56) \
+	X(KEY_CAPSLOCK, 57) \
+	X(KEY_F1, 58) \
+	X(KEY_F2, 59) \
+	X(KEY_F3, 60) \
+	X(KEY_F4, 61) \
+	X(KEY_F5, 62) \
+	X(KEY_F6, 63) \
+	X(KEY_F7, 64) \
+	X(KEY_F8, 65) \
+	X(KEY_F9, 66) \
+	X(KEY_F10, 67) \
+	X(KEY_F11, 68) \
+	X(KEY_F12, 69) \
+	X(KEY_PRINTSCREEN, 70) \
+	X(KEY_SCROLLLOCK, 71) \
+	X(KEY_PAUSE, 72) \
+	X(KEY_INSERT, 73) /* insert on PC, help on some Mac keyboards (but does send code 73, not 117) */ \
+	X(KEY_HOME, 74) \
+	X(KEY_PAGEUP, 75) \
+	X(KEY_DELETE, 76) \
+	X(KEY_END, 77) \
+	X(KEY_PAGEDOWN, 78) \
+	X(KEY_RIGHT, 79) \
+	X(KEY_LEFT, 80) \
+	X(KEY_DOWN, 81) \
+	X(KEY_UP, 82) \
+	X(KEY_NUMLOCKCLEAR, 83) /* num lock on PC, clear on Mac keyboards */ \
+	X(KEY_KP_DIVIDE, 84) \
+	X(KEY_KP_MULTIPLY, 85) \
+	X(KEY_KP_MINUS, 86) \
+	X(KEY_KP_PLUS, 87) \
+	X(KEY_KP_ENTER, 88) \
+	X(KEY_KP_1, 89) \
+	X(KEY_KP_2, 90) \
+	X(KEY_KP_3, 91) \
+	X(KEY_KP_4, 92) \
+	X(KEY_KP_5, 93) \
+	X(KEY_KP_6, 94) \
+	X(KEY_KP_7, 95) \
+	X(KEY_KP_8, 96) \
+	X(KEY_KP_9, 97) \
+	X(KEY_KP_0, 98) \
+	X(KEY_KP_PERIOD, 99) \
+	X(KEY_NONUSBACKSLASH, 100) /* the additional ISO key between left shift and Y */ \
+	X(KEY_APPLICATION, 101) /* windows contextual menu, compose */ \
+	X(KEY_POWER, 102) /* a status flag per the USB document, but some Mac keyboards have a power key */ \
+	X(KEY_KP_EQUALS, 103) \
+	X(KEY_F13, 104) \
+	X(KEY_F14, 105) \
+	X(KEY_F15, 106) \
+	X(KEY_F16, 107) \
+	X(KEY_F17, 108) \
+	X(KEY_F18, 109) \
+	X(KEY_F19, 110) \
+	X(KEY_F20, 111) \
+	X(KEY_F21, 112) \
+	X(KEY_F22, 113) \
+	X(KEY_F23, 114) \
+	X(KEY_F24, 115) \
+	X(KEY_EXECUTE, 116) \
+	X(KEY_HELP, 117) \
+	X(KEY_MENU, 118) \
+	X(KEY_SELECT, 119) \
+	X(KEY_STOP, 120) \
+	X(KEY_AGAIN, 121) /* redo */ \
+	X(KEY_UNDO, 122) \
+	X(KEY_CUT, 123) \
+	X(KEY_COPY, 124) \
+	X(KEY_PASTE, 125) \
+	X(KEY_FIND, 126) \
+	X(KEY_MUTE, 127) \
+	X(KEY_VOLUMEUP, 128) \
+	X(KEY_VOLUMEDOWN, 129) \
+	/* KEY_LOCKINGCAPSLOCK = 130, KEY_LOCKINGNUMLOCK = 131 and KEY_LOCKINGSCROLLLOCK = 132 are left out */ \
+	X(KEY_KP_COMMA, 133) \
+	X(KEY_KP_EQUALSAS400, 134) \
+	X(KEY_INTERNATIONAL1, 135) /* used on Asian keyboards, see footnotes in USB doc */ \
+	X(KEY_INTERNATIONAL2, 136) \
+	X(KEY_INTERNATIONAL3, 137) /* Yen */ \
+	X(KEY_INTERNATIONAL4, 138) \
+	X(KEY_INTERNATIONAL5, 139) \
+	X(KEY_INTERNATIONAL6, 140) \
+	X(KEY_INTERNATIONAL7, 141) \
+	X(KEY_INTERNATIONAL8, 142) \
+	X(KEY_INTERNATIONAL9, 143) \
+	X(KEY_LANG1, 144) /* Hangul/English toggle */ \
+	X(KEY_LANG2, 145) /* Hanja conversion */ \
+	X(KEY_LANG3, 146) /* Katakana */ \
+	X(KEY_LANG4, 147) /* Hiragana */ \
+	X(KEY_LANG5, 148) /* Zenkaku/Hankaku */ \
+	X(KEY_LANG6, 149) /* reserved */ \
+	X(KEY_LANG7, 150) /* reserved */ \
+	X(KEY_LANG8, 151) /* reserved */ \
+	X(KEY_LANG9, 152) /* reserved */ \
+	X(KEY_ALTERASE, 153) /* Erase-Eaze */ \
+	X(KEY_SYSREQ, 154) \
+	X(KEY_CANCEL, 155) \
+	X(KEY_CLEAR, 156) \
+	X(KEY_PRIOR, 157) \
+	X(KEY_RETURN2, 158) \
+	X(KEY_SEPARATOR, 159) \
+	X(KEY_OUT, 160) \
+	X(KEY_OPER, 161) \
+	X(KEY_CLEARAGAIN, 162) \
+	X(KEY_CRSEL, 163) \
+	X(KEY_EXSEL, 164) \
+	X(KEY_KP_00, 176) \
+	X(KEY_KP_000, 177) \
+	X(KEY_THOUSANDSSEPARATOR, 178) \
+	X(KEY_DECIMALSEPARATOR, 179) \
+	X(KEY_CURRENCYUNIT, 180) \
+	X(KEY_CURRENCYSUBUNIT, 181) \
+	X(KEY_KP_LEFTPAREN, 182) \
+	X(KEY_KP_RIGHTPAREN, 183) \
+	X(KEY_KP_LEFTBRACE, 184) \
+	X(KEY_KP_RIGHTBRACE, 185) \
+	X(KEY_KP_TAB, 186) \
+	X(KEY_KP_BACKSPACE, 187) \
+	X(KEY_KP_A, 188) \
+	X(KEY_KP_B, 189) \
+	X(KEY_KP_C, 190) \
+	X(KEY_KP_D, 191) \
+	X(KEY_KP_E, 192) \
+	X(KEY_KP_F, 193) \
+	X(KEY_KP_XOR, 194) \
+	X(KEY_KP_POWER, 195) \
+	X(KEY_KP_PERCENT, 196) \
+	X(KEY_KP_LESS, 197) \
+	X(KEY_KP_GREATER, 198) \
+	X(KEY_KP_AMPERSAND, 199) \
+	X(KEY_KP_DBLAMPERSAND, 200) \
+	X(KEY_KP_VERTICALBAR, 201) \
+	X(KEY_KP_DBLVERTICALBAR, 202) \
+	X(KEY_KP_COLON, 203) \
+	X(KEY_KP_HASH, 204) \
+	X(KEY_KP_SPACE, 205) \
+	X(KEY_KP_AT, 206) \
+	X(KEY_KP_EXCLAM, 207) \
+	X(KEY_KP_MEMSTORE, 208) \
+	X(KEY_KP_MEMRECALL, 209) \
+	X(KEY_KP_MEMCLEAR, 210) \
+	X(KEY_KP_MEMADD, 211) \
+	X(KEY_KP_MEMSUBTRACT, 212) \
+	X(KEY_KP_MEMMULTIPLY, 213) \
+	X(KEY_KP_MEMDIVIDE, 214) \
+	X(KEY_KP_PLUSMINUS, 215) \
+	X(KEY_KP_CLEAR, 216) \
+	X(KEY_KP_CLEARENTRY, 217) \
+	X(KEY_KP_BINARY, 218) \
+	X(KEY_KP_OCTAL, 219) \
+	X(KEY_KP_DECIMAL, 220) \
+	X(KEY_KP_HEXADECIMAL, 221) \
+	X(KEY_LCTRL, 224) \
+	X(KEY_LSHIFT, 225) \
+	X(KEY_LALT, 226) /* alt, option */ \
+	X(KEY_LGUI, 227) /* windows, command (apple), meta */ \
+	X(KEY_RCTRL, 228) \
+	X(KEY_RSHIFT, 229) \
+	X(KEY_RALT, 230) /* alt gr, option */ \
+	X(KEY_RGUI, 231) /* windows, command (apple), meta */ \
+	X(KEY_MODE, 257) /* the key of the special KMOD_MODE */ \
+	/* usage page 0x0C, USB consumer page */ \
+	X(KEY_AUDIONEXT, 258) \
+	X(KEY_AUDIOPREV, 259) \
+	X(KEY_AUDIOSTOP, 260) \
+	X(KEY_AUDIOPLAY, 261) \
+	X(KEY_AUDIOMUTE, 262) \
+	X(KEY_MEDIASELECT, 263) \
+	X(KEY_WWW, 264) \
+	X(KEY_MAIL, 265) \
+	X(KEY_CALCULATOR, 266) \
+	X(KEY_COMPUTER, 267) \
+	X(KEY_AC_SEARCH, 268) \
+	X(KEY_AC_HOME, 269) \
+	X(KEY_AC_BACK, 270) \
+	X(KEY_AC_FORWARD, 271) \
+	X(KEY_AC_STOP, 272) \
+	X(KEY_AC_REFRESH, 273) \
+	X(KEY_AC_BOOKMARKS, 274) \
+	/* Walther keys, added by Christian Walther for Mac keyboards */ \
+	X(KEY_BRIGHTNESSDOWN, 275) \
+	X(KEY_BRIGHTNESSUP, 276) \
+	X(KEY_DISPLAYSWITCH, 277) /* display mirroring/dual display switch, video mode switch */ \
+	X(KEY_KBDILLUMTOGGLE, 278) \
+	X(KEY_KBDILLUMDOWN, 279) \
+	X(KEY_KBDILLUMUP, 280) \
+	X(KEY_EJECT, 281) \
+	X(KEY_SLEEP, 282) \
+	X(KEY_APP1, 283) \
+	X(KEY_APP2, 284)
+
 namespace Dawn
 {
 class Input
@@ -16,351 +265,10 @@ public:
 
 	enum
 	{
-			KEY_UNKNOWN = 0,
-
-		/**
-		 *  \name Usage page 0x07
-		 *
-		 *  These values are from usage page 0x07 (USB keyboard page).
-		 */
-		/*@{*/
-
-		KEY_A = 4,
-		KEY_B = 5,
-		KEY_C = 6,
-		KEY_D = 7,
-		KEY_E = 8,
-		KEY_F = 9,
-		KEY_G = 10,
-		KEY_H = 11,
-		KEY_I = 12,
-		KEY_J = 13,
-		KEY_K = 14,
-		KEY_L = 15,
-		KEY_M = 16,
-		KEY_N = 17,
-		KEY_O = 18,
-		KEY_P = 19,
-		KEY_Q = 20,
-		KEY_R = 21,
-		KEY_S = 22,
-		KEY_T = 23,
-		KEY_U = 24,
-		KEY_V = 25,
-		KEY_W = 26,
-		KEY_X = 27,
-		KEY_Y = 28,
-		KEY_Z = 29,
-
-		KEY_1 = 30,
-		KEY_2 = 31,
-		KEY_3 = 32,
-		KEY_4 = 33,
-		KEY_5 = 34,
-		KEY_6 = 35,
-		KEY_7 = 36,
-		KEY_8 = 37,
-		KEY_9 = 38,
-		KEY_0 = 39,
-
-		KEY_RETURN = 40,
-		KEY_ESCAPE = 41,
-		KEY_BACKSPACE = 42,
-		KEY_TAB = 43,
-		KEY_SPACE = 44,
-
-		KEY_MINUS = 45,
-		KEY_EQUALS = 46,
-		KEY_LEFTBRACKET = 47,
-		KEY_RIGHTBRACKET = 48,
-		KEY_BACKSLASH = 49, /**< Located at the lower left of the return
-									  *   key on ISO keyboards and at the right end
-									  *   of the QWERTY row on ANSI keyboards.
-									  *   Produces REVERSE SOLIDUS (backslash) and
-									  *   VERTICAL LINE in a US layout, REVERSE
-									  *   SOLIDUS and VERTICAL LINE in a UK Mac
-									  *   layout, NUMBER SIGN and TILDE in a UK
-									  *   Windows layout, DOLLAR SIGN and POUND SIGN
-									  *   in a Swiss German layout, NUMBER SIGN and
-									  *   APOSTROPHE in a German layout, GRAVE
-									  *   ACCENT and POUND SIGN in a French Mac
-									  *   layout, and ASTERISK and MICRO SIGN in a
-									  *   French Windows layout.
-									  */
-		KEY_NONUSHASH = 50, /**< ISO USB keyboards actually use this code
-									  *   instead of 49 for the same key, but all
-									  *   OSes I've seen treat the two codes
-									  *   identically. So, as an implementor, unless
-									  *   your keyboard generates both of those
-									  *   codes and your OS treats them differently,
-									  *   you should generate KEY_BACKSLASH
-									  *   instead of this code. As a user, you
-									  *   should not rely on this code because SDL
-									  *   will never generate it with most (all?)
-									  *   keyboards.
-									  */
-		KEY_SEMICOLON = 51,
-		KEY_APOSTROPHE = 52,
-		KEY_GRAVE = 53, /**< Located in the top left corner (on both ANSI
-								  *   and ISO keyboards). Produces GRAVE ACCENT and
-								  *   TILDE in a US Windows layout and in US and UK
-								  *   Mac layouts on ANSI keyboards, GRAVE ACCENT
-								  *   and NOT SIGN in a UK Windows layout, SECTION
-								  *   SIGN and PLUS-MINUS SIGN in US and UK Mac
-								  *   layouts on ISO keyboards, SECTION SIGN and
-								  *   DEGREE SIGN in a Swiss German layout (Mac:
-								  *   only on ISO keyboards), CIRCUMFLEX ACCENT and
-								  *   DEGREE SIGN in a German layout (Mac: only on
-								  *   ISO keyboards), SUPERSCRIPT TWO and TILDE in a
-								  *   French Windows layout, COMMERCIAL AT and
-								  *   NUMBER SIGN in a French Mac layout on ISO
-								  *   keyboards, and LESS-THAN SIGN and GREATER-THAN
-								  *   SIGN in a Swiss German, German, or French Mac
-								  *   layout on ANSI keyboards.
-								  */
-		KEY_COMMA = 54,
-		KEY_PERIOD = 55,
-		KEY_SLASH = 56,
-
-		KEY_CAPSLOCK = 57,
-
-		KEY_F1 = 58,
-		KEY_F2 = 59,
-		KEY_F3 = 60,
-		KEY_F4 = 61,
-		KEY_F5 = 62,
-		KEY_F6 = 63,
-		KEY_F7 = 64,
-		KEY_F8 = 65,
-		KEY_F9 = 66,
-		KEY_F10 = 67,
-		KEY_F11 = 68,
-		KEY_F12 = 69,
-
-		KEY_PRINTSCREEN = 70,
-		KEY_SCROLLLOCK = 71,
-		KEY_PAUSE = 72,
-		KEY_INSERT = 73, /**< insert on PC, help on some Mac keyboards (but
-									   does send code 73, not 117) */
-		KEY_HOME = 74,
-		KEY_PAGEUP = 75,
-		KEY_DELETE = 76,
-		KEY_END = 77,
-		KEY_PAGEDOWN = 78,
-		KEY_RIGHT = 79,
-		KEY_LEFT = 80,
-		KEY_DOWN = 81,
-		KEY_UP = 82,
-
-		KEY_NUMLOCKCLEAR = 83, /**< num lock on PC, clear on Mac keyboards
-										 */
-		KEY_KP_DIVIDE = 84,
-		KEY_KP_MULTIPLY = 85,
-		KEY_KP_MINUS = 86,
-		KEY_KP_PLUS = 87,
-		KEY_KP_ENTER = 88,
-		KEY_KP_1 = 89,
-		KEY_KP_2 = 90,
-		KEY_KP_3 = 91,
-		KEY_KP_4 = 92,
-		KEY_KP_5 = 93,
-		KEY_KP_6 = 94,
-		KEY_KP_7 = 95,
-		KEY_KP_8 = 96,
-		KEY_KP_9 = 97,
-		KEY_KP_0 = 98,
-		KEY_KP_PERIOD = 99,
-
-		KEY_NONUSBACKSLASH = 100, /**< This is the additional key that ISO
-											*   keyboards have over ANSI ones,
-											*   located between left shift and Y.
-											*   Produces GRAVE ACCENT and TILDE in a
-											*   US or UK Mac layout, REVERSE SOLIDUS
-											*   (backslash) and VERTICAL LINE in a
-											*   US or UK Windows layout, and
-											*   LESS-THAN SIGN and GREATER-THAN SIGN
-											*   in a Swiss German, German, or French
-											*   layout. */
-		KEY_APPLICATION = 101, /**< windows contextual menu, compose */
-		KEY_POWER = 102, /**< The USB document says this is a status flag,
-								   *   not a physical key - but some Mac keyboards
-								   *   do have a power key. */
-		KEY_KP_EQUALS = 103,
-		KEY_F13 = 104,
-		KEY_F14 = 105,
-		KEY_F15 = 106,
-		KEY_F16 = 107,
-		KEY_F17 = 108,
-		KEY_F18 = 109,
-		KEY_F19 = 110,
-		KEY_F20 = 111,
-		KEY_F21 = 112,
-		KEY_F22 = 113,
-		KEY_F23 = 114,
-		KEY_F24 = 115,
-		KEY_EXECUTE = 116,
-		KEY_HELP = 117,
-		KEY_MENU = 118,
-		KEY_SELECT = 119,
-		KEY_STOP = 120,
-		KEY_AGAIN = 121,   /**< redo */
-		KEY_UNDO = 122,
-		KEY_CUT = 123,
-		KEY_COPY = 124,
-		KEY_PASTE = 125,
-		KEY_FIND = 126,
-		KEY_MUTE = 127,
-		KEY_VOLUMEUP = 128,
-		KEY_VOLUMEDOWN = 129,
-	/* not sure whether there's a reason to enable these */
-	/*     KEY_LOCKINGCAPSLOCK = 130,  */
-	/*     KEY_LOCKINGNUMLOCK = 131, */
-	/*     KEY_LOCKINGSCROLLLOCK = 132, */
-		KEY_KP_COMMA = 133,
-		KEY_KP_EQUALSAS400 = 134,
-
-		KEY_INTERNATIONAL1 = 135, /**< used on Asian keyboards, see
-												footnotes in USB doc */
-		KEY_INTERNATIONAL2 = 136,
-		KEY_INTERNATIONAL3 = 137, /**< Yen */
-		KEY_INTERNATIONAL4 = 138,
-		KEY_INTERNATIONAL5 = 139,
-		KEY_INTERNATIONAL6 = 140,
-		KEY_INTERNATIONAL7 = 141,
-		KEY_INTERNATIONAL8 = 142,
-		KEY_INTERNATIONAL9 = 143,
-		KEY_LANG1 = 144, /**< Hangul/English toggle */
-		KEY_LANG2 = 145, /**< Hanja conversion */
-		KEY_LANG3 = 146, /**< Katakana */
-		KEY_LANG4 = 147, /**< Hiragana */
-		KEY_LANG5 = 148, /**< Zenkaku/Hankaku */
-		KEY_LANG6 = 149, /**< reserved */
-		KEY_LANG7 = 150, /**< reserved */
-		KEY_LANG8 = 151, /**< reserved */
-		KEY_LANG9 = 152, /**< reserved */
-
-		KEY_ALTERASE = 153, /**< Erase-Eaze */
-		KEY_SYSREQ = 154,
-		KEY_CANCEL = 155,
-		KEY_CLEAR = 156,
-		KEY_PRIOR = 157,
-		KEY_RETURN2 = 158,
-		KEY_SEPARATOR = 159,
-		KEY_OUT = 160,
-		KEY_OPER = 161,
-		KEY_CLEARAGAIN = 162,
-		KEY_CRSEL = 163,
-		KEY_EXSEL = 164,
-
-		KEY_KP_00 = 176,
-		KEY_KP_000 = 177,
-		KEY_THOUSANDSSEPARATOR = 178,
-		KEY_DECIMALSEPARATOR = 179,
-		KEY_CURRENCYUNIT = 180,
-		KEY_CURRENCYSUBUNIT = 181,
-		KEY_KP_LEFTPAREN = 182,
-		KEY_KP_RIGHTPAREN = 183,
-		KEY_KP_LEFTBRACE = 184,
-		KEY_KP_RIGHTBRACE = 185,
-		KEY_KP_TAB = 186,
-		KEY_KP_BACKSPACE = 187,
-		KEY_KP_A = 188,
-		KEY_KP_B = 189,
-		KEY_KP_C = 190,
-		KEY_KP_D = 191,
-		KEY_KP_E = 192,
-		KEY_KP_F = 193,
-		KEY_KP_XOR = 194,
-		KEY_KP_POWER = 195,
-		KEY_KP_PERCENT = 196,
-		KEY_KP_LESS = 197,
-		KEY_KP_GREATER = 198,
-		KEY_KP_AMPERSAND = 199,
-		KEY_KP_DBLAMPERSAND = 200,
-		KEY_KP_VERTICALBAR = 201,
-		KEY_KP_DBLVERTICALBAR = 202,
-		KEY_KP_COLON = 203,
-		KEY_KP_HASH = 204,
-		KEY_KP_SPACE = 205,
-		KEY_KP_AT = 206,
-		KEY_KP_EXCLAM = 207,
-		KEY_KP_MEMSTORE = 208,
-		KEY_KP_MEMRECALL = 209,
-		KEY_KP_MEMCLEAR = 210,
-		KEY_KP_MEMADD = 211,
-		KEY_KP_MEMSUBTRACT = 212,
-		KEY_KP_MEMMULTIPLY = 213,
-		KEY_KP_MEMDIVIDE = 214,
-		KEY_KP_PLUSMINUS = 215,
-		KEY_KP_CLEAR = 216,
-		KEY_KP_CLEARENTRY = 217,
-		KEY_KP_BINARY = 218,
-		KEY_KP_OCTAL = 219,
-		KEY_KP_DECIMAL = 220,
-		KEY_KP_HEXADECIMAL = 221,
-
-		KEY_LCTRL = 224,
-		KEY_LSHIFT = 225,
-		KEY_LALT = 226, /**< alt, option */
-		KEY_LGUI = 227, /**< windows, command (apple), meta */
-		KEY_RCTRL = 228,
-		KEY_RSHIFT = 229,
-		KEY_RALT = 230, /**< alt gr, option */
-		KEY_RGUI = 231, /**< windows, command (apple), meta */
-
-		KEY_MODE = 257,    /**< I'm not sure if this is really not covered
-									 *   by any of the above, but since there's a
-									 *   special KMOD_MODE for it I'm adding it here
-									 */
-
-		/*@}*//*Usage page 0x07*/
-
-		/**
-		 *  \name Usage page 0x0C
-		 *
-		 *  These values are mapped from usage page 0x0C (USB consumer page).
-		 */
-		/*@{*/
-
-		KEY_AUDIONEXT = 258,
-		KEY_AUDIOPREV = 259,
-		KEY_AUDIOSTOP = 260,
-		KEY_AUDIOPLAY = 261,
-		KEY_AUDIOMUTE = 262,
-		KEY_MEDIASELECT = 263,
-		KEY_WWW = 264,
-		KEY_MAIL = 265,
-		KEY_CALCULATOR = 266,
-		KEY_COMPUTER = 267,
-		KEY_AC_SEARCH = 268,
-		KEY_AC_HOME = 269,
-		KEY_AC_BACK = 270,
-		KEY_AC_FORWARD = 271,
-		KEY_AC_STOP = 272,
-		KEY_AC_REFRESH = 273,
-		KEY_AC_BOOKMARKS = 274,
-
-		/*@}*//*Usage page 0x0C*/
-
-		/**
-		 *  \name Walther keys
-		 *
-		 *  These are values that Christian Walther added (for mac keyboard?).
-		 */
-		/*@{*/
-
-		KEY_BRIGHTNESSDOWN = 275,
-		KEY_BRIGHTNESSUP = 276,
-		KEY_DISPLAYSWITCH = 277, /**< display mirroring/dual display
-											   switch, video mode switch */
-		KEY_KBDILLUMTOGGLE = 278,
-		KEY_KBDILLUMDOWN = 279,
-		KEY_KBDILLUMUP = 280,
-		KEY_EJECT = 281,
-		KEY_SLEEP = 282,
-
-		KEY_APP1 = 283,
-		KEY_APP2 = 284
+		KEY_UNKNOWN = 0,
+#define DAWN_INPUT_KEY_ENUM(name, code) name = code,
+		DAWN_INPUT_KEYS(DAWN_INPUT_KEY_ENUM)
+#undef DAWN_INPUT_KEY_ENUM
 	};
 
 	static const int NUM_KEYS = 512;
@@ -0,0 +1,97 @@
+#include "input_state.h"
+#include <algorithm>
+
+namespace Dawn
+{
+	InputState& InputState::getInputState()
+	{
+		static InputState inputState;
+		return inputState;
+	}
+
+	void InputState::press(uint64* down, uint64* pressed, uint32 words, uint32 code)
+	{
+		uint32 word = (code >> 6) & (words - 1);
+		uint64 bit = (uint64)1 << (code & 63);
+
+		// only an up to down transition is an edge
+		pressed[word] |= bit & ~down[word];
+		down[word] |= bit;
+	}
+
+	void InputState::release(uint64* down, uint64* released, uint32 words, uint32 code)
+	{
+		uint32 word = (code >> 6) & (words - 1);
+		uint64 bit = (uint64)1 << (code & 63);
+
+		released[word] |= bit & down[word];
+		down[word] &= ~bit;
+	}
+
+	void InputState::beginFrame()
+	{
+		std::fill(m_keysPressed, m_keysPressed + KEY_WORDS, 0);
+		std::fill(m_keysReleased, m_keysReleased + KEY_WORDS, 0);
+		std::fill(m_buttonsPressed, m_buttonsPressed + BUTTON_WORDS, 0);
+		std::fill(m_buttonsReleased, m_buttonsReleased + BUTTON_WORDS, 0);
+
+		m_mouseDeltaX = 0;
+		m_mouseDeltaY = 0;
+		m_wheelX = 0;
+		m_wheelY = 0;
+	}
+
+	void InputState::onKeyDown(uint32 keyCode, bool isRepeat)
+	{
+		if(!isRepeat)
+			press(m_keysDown, m_keysPressed, KEY_WORDS, keyCode);
+	}
+
+	void InputState::onKeyUp(uint32 keyCode)
+	{
+		release(m_keysDown, m_keysReleased, KEY_WORDS, keyCode);
+	}
+
+	void InputState::onMouseButtonDown(uint32 mouseButton, int32 posX, int32 posY)
+	{
+		press(m_buttonsDown, m_buttonsPressed, BUTTON_WORDS, mouseButton);
+		m_mouseX = posX;
+		m_mouseY = posY;
+	}
+
+	void InputState::onMouseButtonUp(uint32 mouseButton, int32 posX, int32 posY)
+	{
+		release(m_buttonsDown, m_buttonsReleased, BUTTON_WORDS, mouseButton);
+		m_mouseX = posX;
+		m_mouseY = posY;
+	}
+
+	void InputState::onMouseMove(int32 posX, int32 posY, int32 deltaX, int32 deltaY)
+	{
+		m_mouseX = posX;
+		m_mouseY = posY;
+		m_mouseDeltaX += deltaX;
+		m_mouseDeltaY += deltaY;
+	}
+
+	void InputState::onMouseWheel(int32 wheelX, int32 wheelY)
+	{
+		m_wheelX += wheelX;
+		m_wheelY += wheelY;
+	}
+
+	void InputState::releaseAll()
+	{
+		for(uint32 i = 0; i < KEY_WORDS; i++)
+		{
+			m_keysReleased[i] |= m_keysDown[i];
+			m_keysDown[i] = 0;
+		}
+
+		for(uint32 i = 0; i < BUTTON_WORDS; i++)
+		{
+			m_buttonsReleased[i] |= m_buttonsDown[i];
+			m_buttonsDown[i] = 0;
+		}
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "common.h"
+#include "input.h"
+
+namespace Dawn
+{
+	// Polled view of the keyboard and mouse, for code that only wants to know
+	// whether a key is down or went down this frame. The EventQueue updates it
+	// while it drains, so it's current from the drain until the next one and
+	// is read on the main thread. Copies of it carry a frame's input to the
+	// simulation thread. Keys are Input scancodes, buttons Input mouse
+	// buttons; queries are a shift and a mask, out of range codes wrap instead
+	// of being checked.
+	class InputState
+	{
+	public:
+		static const uint32 KEY_WORDS = Input::NUM_KEYS / 64;
+		static const uint32 BUTTON_WORDS = Input::NUM_MOUSEBUTTONS / 64;
+
+	private:
+		uint64 m_keysDown[KEY_WORDS]{};
+		uint64 m_keysPressed[KEY_WORDS]{};
+		uint64 m_keysReleased[KEY_WORDS]{};
+
+		uint64 m_buttonsDown[BUTTON_WORDS]{};
+		uint64 m_buttonsPressed[BUTTON_WORDS]{};
+		uint64 m_buttonsReleased[BUTTON_WORDS]{};
+
+		int32 m_mouseX{};
+		int32 m_mouseY{};
+		// summed over the frame
+		int32 m_mouseDeltaX{};
+		int32 m_mouseDeltaY{};
+		int32 m_wheelX{};
+		int32 m_wheelY{};
+
+		static inline bool testBit(const uint64* bits, uint32 words, uint32 code)
+		{
+			return ((bits[(code >> 6) & (words - 1)] >> (code & 63)) & 1) != 0;
+		}
+
+		static void press(uint64* down, uint64* pressed, uint32 words, uint32 code);
+		static void release(uint64* down, uint64* released, uint32 words, uint32 code);
+
+	public:
+		InputState() {}
+		~InputState() {}
+
+		static InputState& getInputState();
+
+		// Start of the drain, clears the edges and the per-frame deltas.
+		void beginFrame();
+
+		// Key repeats don't produce edges.
+		void onKeyDown(uint32 keyCode, bool isRepeat);
+		void onKeyUp(uint32 keyCode);
+		void onMouseButtonDown(uint32 mouseButton, int32 posX, int32 posY);
+		void onMouseButtonUp(uint32 mouseButton, int32 posX, int32 posY);
+		void onMouseMove(int32 posX, int32 posY, int32 deltaX, int32 deltaY);
+		void onMouseWheel(int32 wheelX, int32 wheelY);
+		// Releases everything held, the key ups go to the other window.
+		void releaseAll();
+
+		inline bool isKeyDown(uint32 keyCode) const { return testBit(m_keysDown, KEY_WORDS, keyCode); }
+		// A tap within one frame counts as both pressed and released.
+		inline bool wasKeyPressed(uint32 keyCode) const { return testBit(m_keysPressed, KEY_WORDS, keyCode); }
+		inline bool wasKeyReleased(uint32 keyCode) const { return testBit(m_keysReleased, KEY_WORDS, keyCode); }
+
+		inline bool isMouseButtonDown(uint32 mouseButton) const { return testBit(m_buttonsDown, BUTTON_WORDS, mouseButton); }
+		inline bool wasMouseButtonPressed(uint32 mouseButton) const { return testBit(m_buttonsPressed, BUTTON_WORDS, mouseButton); }
+		inline bool wasMouseButtonReleased(uint32 mouseButton) const { return testBit(m_buttonsReleased, BUTTON_WORDS, mouseButton); }
+
+		// Whole bitsets, KEY_WORDS and BUTTON_WORDS words long.
+		inline const uint64* getKeysDown() const { return m_keysDown; }
+		inline const uint64* getKeysPressed() const { return m_keysPressed; }
+		inline const uint64* getMouseButtonsDown() const { return m_buttonsDown; }
+		inline const uint64* getMouseButtonsPressed() const { return m_buttonsPressed; }
+
+		inline int32 getMouseX() const { return m_mouseX; }
+		inline int32 getMouseY() const { return m_mouseY; }
+		inline int32 getMouseDeltaX() const { return m_mouseDeltaX; }
+		inline int32 getMouseDeltaY() const { return m_mouseDeltaY; }
+		inline int32 getWheelX() const { return m_wheelX; }
+		inline int32 getWheelY() const { return m_wheelY; }
+	};
+}
@@ -1,7 +1,8 @@
 #include "sdl_application.h"
 #include <glad/glad.h>
 #include "core/app_state.h"
-#include "core/events/event_handler.h"
+#include "core/events/event_bus.h"
+#include "core/events/event_queue.h"
 #include "core/common.h"
  
 namespace Dawn
@@ -23,8 +24,10 @@ namespace Dawn
 		SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+        // SpriteBatch depth sorting relies on a depth buffer
+        SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
    
-        sdlWindow = SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, SDL_WINDOW_OPENGL);
+        sdlWindow = SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
         DAWN_INTERNAL_ASSERT(sdlWindow != nullptr, "Couldn't create SDL window");
    
         SDL_ShowWindow(sdlWindow);
@@ -36,7 +39,41 @@ namespace Dawn
         DAWN_INTERNAL_ASSERT(success != 0, "Couldn't initialize glad");
    
         SDL_GL_MakeCurrent(sdlWindow, windowContext);
+        setVsyncMode(m_vsyncMode);
+        wakeUpEventType = SDL_RegisterEvents(1);
         SDL_GL_SwapWindow(sdlWindow);
+
+        // the renderer works in pixels, more of them than window units on HiDPI screens
+        int drawableWidth = 0;
+        int drawableHeight = 0;
+        SDL_GL_GetDrawableSize(sdlWindow, &drawableWidth, &drawableHeight);
+        initRenderer(drawableWidth, drawableHeight);
+	}
+
+	void SdlApplication::setVsyncMode(VsyncMode mode)
+	{
+		int interval = 0;
+		switch(mode)
+		{
+			case VsyncMode::OFF:      interval = 0;  break;
+			case VsyncMode::ON:       interval = 1;  break;
+			case VsyncMode::ADAPTIVE: interval = -1; break;
+		}
+
+		if(SDL_GL_SetSwapInterval(interval) != 0)
+		{
+			if(mode == VsyncMode::ADAPTIVE)
+			{
+				DAWN_INTERNAL_WARN("Adaptive vsync unsupported, using vsync: {}", SDL_GetError());
+				mode = VsyncMode::ON;
+				interval = 1;
+			}
+
+			if(mode != VsyncMode::ON || SDL_GL_SetSwapInterval(interval) != 0)
+				DAWN_INTERNAL_ERROR("Couldn't set swap interval {}: {}", interval, SDL_GetError());
+		}
+
+		m_vsyncMode = mode;
 	}
 
 	AppState * AppState::create()
@@ -53,38 +90,154 @@ namespace Dawn
 	{
 		isAppRunning = true;
 		while(isAppRunning) {
+			// also runs on idle wake-ups, so on-demand mode fires timers within the idle timeout
+			updateTimers();
+
+			bool isIdle = !isRedrawNeeded();
+			if(isIdle)
+				waitForEvents();
+			else
+				m_frameTimer.beginFrame();
+
 			processEvents();
+			// the one point in the frame listeners see input, before simulation;
+			// idle iterations drain too, a minimized window is only restored by
+			// the WINDOW_RESTORE that woke it
+			EventQueue::getEventQueue().drain();
+			updateActions();
+			// a benchmark run ends with its recording
+			if(m_isQuittingAfterReplay && !EventQueue::getEventQueue().isReplaying())
+				isAppRunning = false;
+
+			// only the frame is skipped when nothing asks for one
+			if(!isRedrawNeeded())
+				continue;
+			if(isIdle)
+				m_frameTimer.beginFrame();
+
+			// cleared before rendering so an invalidate() during the frame asks for another one
+			m_isInvalidated = false;
+			renderFrame();
+			// end of frame for deferred bus events, ones enqueued meanwhile invalidate for the next frame
+			EventBus::getEventBus().deliverDeferred();
+			m_frameTimer.endCpuWork();
+			// the scale follows what rendering cost, CPU and GPU, up to the
+			// swap; with vsync on the swap alone would fill the budget
+			m_dynamicResolution.waitForGpu();
+			m_dynamicResolution.addFrameTime(m_frameTimer.getFrameElapsedMs());
+			SDL_GL_SwapWindow(sdlWindow);
+			m_frameTimer.markPresent();
+			// no-op unless a frame rate cap is set, vsync paces the loop otherwise
+			m_framePacer.waitForNextFrame();
+		}
+
+		shutdownRenderer();
+	}
+
+	void SdlApplication::waitForEvents()
+	{
+		SDL_Event e;
+		if(SDL_WaitEventTimeout(&e, m_idleTimeoutMs)) {
+			handleEvent(e);
+			// any input may change what's on screen, the next iteration renders it
+			m_isInvalidated = true;
 		}
+
+		// the time spent blocked belongs to no frame
+		m_frameTimer.skipFrame();
+		m_framePacer.resync();
+		m_fixedTimestep.resync();
+		m_dynamicResolution.resync();
+	}
+
+	void SdlApplication::wakeUp()
+	{
+		if(wakeUpEventType == 0 || wakeUpEventType == (uint32)-1)
+			return;
+
+		// SDL_PushEvent is safe to call from any thread
+		SDL_Event e{};
+		e.type = wakeUpEventType;
+		SDL_PushEvent(&e);
 	}
 
 	void SdlApplication::processEvents()
 	{
 		static SDL_Event e;
 		while(SDL_PollEvent(&e)) {
-		   switch(e.type){
-		      case SDL_KEYDOWN:
-			    EventHandler::getEventHandler()->onKeyDown(e.key.keysym.scancode, e.key.repeat != 0);
-			    break;
-		      case SDL_KEYUP:
-			    EventHandler::getEventHandler()->onKeyUp(e.key.keysym.scancode, e.key.repeat != 0);
-			    break;
-		      case SDL_MOUSEBUTTONDOWN:
-			    EventHandler::getEventHandler()->onMouseButtonDown(e.button.button, e.button.clicks, e.button.x, e.button.y);
-			    break;
-		      case SDL_MOUSEBUTTONUP:
-			    EventHandler::getEventHandler()->onMouseButtonUp(e.button.button, e.button.clicks, e.button.x, e.button.y);
-			    break;
-		      case SDL_MOUSEMOTION:
-			    EventHandler::getEventHandler()->onMouseMove(e.motion.x, e.motion.y, e.motion.xrel, e.motion.yrel);
-			    break;
-		      case SDL_QUIT:
-			    isAppRunning = false;
-			    break;
-		      default:
-			    break;
+			handleEvent(e);
+		}
+	}
+
+	void SdlApplication::handleEvent(const SDL_Event& e)
+	{
+		QueuedEvent event{};
+		switch(e.type){
+		   case SDL_KEYDOWN:
+		   case SDL_KEYUP:
+			 event.type = e.type == SDL_KEYDOWN ? Event::KEY_DOWN : Event::KEY_UP;
+			 event.key.keyCode = e.key.keysym.scancode;
+			 event.key.isRepeat = e.key.repeat != 0;
+			 break;
+		   case SDL_MOUSEBUTTONDOWN:
+		   case SDL_MOUSEBUTTONUP:
+			 event.type = e.type == SDL_MOUSEBUTTONDOWN ? Event::MOUSE_BUTTON_DOWN : Event::MOUSE_BUTTON_UP;
+			 event.mouseButton.mouseButton = e.button.button;
+			 event.mouseButton.numClicks = e.button.clicks;
+			 event.mouseButton.posX = e.button.x;
+			 event.mouseButton.posY = e.button.y;
+			 break;
+		   case SDL_MOUSEMOTION:
+			 event.type = Event::MOUSE_MOVE;
+			 event.mouseMove.posX = e.motion.x;
+			 event.mouseMove.posY = e.motion.y;
+			 event.mouseMove.deltaX = e.motion.xrel;
+			 event.mouseMove.deltaY = e.motion.yrel;
+			 break;
+		   case SDL_MOUSEWHEEL:
+			 event.type = Event::MOUSE_WHEEL;
+			 // natural scrolling reports flipped values, undo it so positive is always away from the user
+			 event.mouseWheel.wheelX = e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -e.wheel.x : e.wheel.x;
+			 event.mouseWheel.wheelY = e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -e.wheel.y : e.wheel.y;
+			 break;
+		   case SDL_WINDOWEVENT:
+			 event.type = translateWindowEvent(e.window, event.window);
+			 break;
+		   case SDL_QUIT:
+			 isAppRunning = false;
+			 break;
+		   default:
+			 break;
 		};
-	    }
+
+		// dispatched when the loop drains the queue, not from inside the poll
+		if(event.type != Event::NONE)
+			EventQueue::getEventQueue().push(event);
 	}
 
+	Event::EventType SdlApplication::translateWindowEvent(const SDL_WindowEvent& e, WindowEventData& data)
+	{
+		switch(e.event){
+		   case SDL_WINDOWEVENT_SIZE_CHANGED:
+		   {
+			 // data1 and data2 are in window units, the viewport needs pixels
+			 int width = 0;
+			 int height = 0;
+			 SDL_GL_GetDrawableSize(sdlWindow, &width, &height);
+			 data.width = width;
+			 data.height = height;
+			 return Event::WINDOW_RESIZE;
+		   }
+		   case SDL_WINDOWEVENT_MINIMIZED:
+			 return Event::WINDOW_MINIMIZE;
+		   case SDL_WINDOWEVENT_RESTORED:
+			 return Event::WINDOW_RESTORE;
+		   case SDL_WINDOWEVENT_FOCUS_LOST:
+			 return Event::WINDOW_FOCUS_LOST;
+		   case SDL_WINDOWEVENT_FOCUS_GAINED:
+			 return Event::WINDOW_FOCUS_GAINED;
+		   default:
+			 return Event::NONE;
+		};
+	}
 }
-
@@ -2,24 +2,31 @@
 
 #include <SDL.h>
 #include "core/app_state.h"
+#include "core/events/event_queue.h"
 
 namespace Dawn
 {
 	class SdlApplication : public AppState
 	{
-		bool isAppRunning{};
 		SDL_Window* sdlWindow{};
 		SDL_GLContext windowContext{};
+		uint32 wakeUpEventType{};
+
+		void handleEvent(const SDL_Event& e);
+		Event::EventType translateWindowEvent(const SDL_WindowEvent& e, WindowEventData& data);
+		void waitForEvents();
 	public:
 		static SdlApplication* create();
 
 		void sdlInit();
 
         void initWindow(const std::string& title, uint32 width, uint32 height) override; 
-        uint32 getFps() const override { /* TODO: Implementation */ };
+        uint32 getFps() const override { return (uint32)(m_frameTimer.getAverageFps() + 0.5f); }
         void execute() override;
+        void setVsyncMode(VsyncMode mode) override;
         
         void processEvents() override;
+        void wakeUp() override;
 	};
 }
 
@@ -1,9 +1,135 @@
 #include "spritebatch.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "graphics/shader.h"
+#include "graphics/light_culling.h"
+#include "graphics/overdraw_heatmap.h"
 
 namespace Dawn
 {
+	namespace
+	{
+		// edge length in pixels of a cell of the CPU overdraw grid
+		const uint32 OVERDRAW_CELL_SIZE = 4;
+
+		const float DEFAULT_SPRITE_DEPTH = 0.5f;
+
+		const GLchar* vertexShaderSource = {
+		R"(
+			#version 300 es
+
+			layout (location = 0) in vec3 pos;
+			layout (location = 1) in vec2 uvIn;
+
+			uniform mat4 mvp;
+
+			out vec2 uv;
+
+			void main()
+			{
+				gl_Position = mvp * vec4(pos, 1.0f);
+				uv = uvIn;
+			}
+		)"
+		};
+
+		const GLchar* fragmentShaderSource = {
+		R"(
+			#version 300 es
+
+			precision mediump float;
+
+			out vec4 color;
+			in vec2 uv;
+
+			uniform sampler2D tex;
+
+			void main()
+			{
+				color = texture(tex, uv);
+			}
+		)"
+		};
+
+		// accumulates the lights of the tile the fragment falls into
+		const GLchar* litFragmentShaderSource = {
+		R"(
+			#version 300 es
+
+			precision highp float;
+			precision highp int;
+
+			out vec4 color;
+			in vec2 uv;
+
+			uniform sampler2D tex;
+			uniform sampler2D normalMap;
+
+			uniform highp sampler2D lightData;
+			uniform highp usampler2D tileHeaders;
+			uniform highp usampler2D lightIndices;
+
+			uniform int tileSize;
+			uniform ivec2 tileCount;
+			uniform int indexTextureWidth;
+			// lights and tiles are in pixels of the render target, y down
+			uniform float targetHeight;
+			uniform float lightHeight;
+			uniform vec3 ambient;
+
+			void main()
+			{
+				vec4 albedo = texture(tex, uv);
+				vec3 normal = texture(normalMap, uv).xyz * 2.0f - 1.0f;
+				// normal maps are authored y up, the screen space is y down
+				normal = normalize(vec3(normal.x, -normal.y, normal.z));
+
+				vec2 pixel = vec2(gl_FragCoord.x, targetHeight - gl_FragCoord.y);
+				ivec2 tile = min(ivec2(pixel) / tileSize, tileCount - 1);
+				uvec2 header = texelFetch(tileHeaders, tile, 0).xy;
+
+				vec3 light = ambient;
+				for(uint i = 0u; i < header.y; i++)
+				{
+					int index = int(header.x + i);
+					int lightIndex = int(texelFetch(lightIndices, ivec2(index % indexTextureWidth, index / indexTextureWidth), 0).r);
+					vec4 posRadius = texelFetch(lightData, ivec2(0, lightIndex), 0);
+					vec4 colorIntensity = texelFetch(lightData, ivec2(1, lightIndex), 0);
+
+					vec3 toLight = vec3(posRadius.xy - pixel, lightHeight);
+					float distance = length(toLight.xy);
+					float attenuation = clamp(1.0f - distance / posRadius.z, 0.0f, 1.0f);
+					float diffuse = max(dot(normal, normalize(toLight)), 0.0f);
+					light += colorIntensity.rgb * colorIntensity.a * attenuation * attenuation * diffuse;
+				}
+
+				color = vec4(albedo.rgb * light, albedo.a);
+			}
+		)"
+		};
+
+		// every shaded fragment adds one step to the 8 bit heatmap target
+		const GLchar* heatmapFragmentShaderSource = {
+		R"(
+			#version 300 es
+
+			precision mediump float;
+
+			out vec4 color;
+			in vec2 uv;
+
+			void main()
+			{
+				color = vec4(1.0f / 255.0f, 0.0f, 0.0f, 0.0f);
+			}
+		)"
+		};
+	}
+
 	SpriteBatch::SpriteBatch()
 	{
 
@@ -14,124 +140,314 @@ namespace Dawn
 
 	}
 
-	void SpriteBatch::registerBatch(GLuint texture, GLuint vertexArray, GLuint vertexBuffer, GLuint shaderProgram)
-	{ 
-		for(auto& b : m_batches)
-		{
-			if(b.texture == texture)
-			return;
-		}
+	void SpriteBatch::initGL()
+	{
+		glGenVertexArrays(1, &m_vertexArray);
+		glBindVertexArray(m_vertexArray);
+
+		glGenBuffers(1, &m_vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, x));
+
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, u));
+
+		glBindVertexArray(0);
+
+		m_shaderProgram = createShaderProgram(vertexShaderSource, fragmentShaderSource);
+		m_mvpLocation = glGetUniformLocation(m_shaderProgram, "mvp");
+
+		glUseProgram(m_shaderProgram);
+		glUniform1i(glGetUniformLocation(m_shaderProgram, "tex"), 0);
+
+		m_heatmapProgram = createShaderProgram(vertexShaderSource, heatmapFragmentShaderSource);
+		m_heatmapMvpLocation = glGetUniformLocation(m_heatmapProgram, "mvp");
+
+		m_litProgram = createShaderProgram(vertexShaderSource, litFragmentShaderSource);
+		m_litMvpLocation = glGetUniformLocation(m_litProgram, "mvp");
 
-		Batch batch;
-		batch.texture = texture;
-		batch.vertexArray = vertexArray;
-		batch.vertexBuffer = vertexBuffer;
-		batch.shaderProgram = shaderProgram;
+		glUseProgram(m_litProgram);
+		glUniform1i(glGetUniformLocation(m_litProgram, "tex"), 0);
+		glUniform1i(glGetUniformLocation(m_litProgram, "normalMap"), 1);
 
-		m_batches.emplace_back(batch);
+		// stands in for sprites without a normal map
+		const uint8 flatNormal[4] = { 128, 128, 255, 255 };
+		glGenTextures(1, &m_flatNormalTexture);
+		glBindTexture(GL_TEXTURE_2D, m_flatNormalTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, flatNormal);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		m_isInitialized = true;
+	}
+
+	void SpriteBatch::setViewport(uint32 width, uint32 height)
+	{
+		m_viewportWidth = width;
+		m_viewportHeight = height;
 	}
 
 	void SpriteBatch::begin()
 	{
-		m_modelViewProj = glm::ortho(0.0f, 800.0f, 600.0f, 0.0f, -1.0f, 1.0f);
+		// depth maps to z = -depth, so the near plane sits at 0 and the far one at 1,
+		// GL_LEQUAL keeps sprites on the far plane against a depth clear of 1
+		m_modelViewProj = glm::ortho(0.0f, (float)m_viewportWidth, (float)m_viewportHeight, 0.0f, 0.0f, 1.0f);
+		m_sprites.clear();
 	}
 
 	void SpriteBatch::add(GLuint texture, const glm::vec2& pos, const glm::vec2& size)
 	{
-		static GLuint vertexArray;
-		glGenVertexArrays(1, &vertexArray);
-		glBindVertexArray(vertexArray);
+		add(texture, pos, size, DEFAULT_SPRITE_DEPTH, false);
+	}
+
+	void SpriteBatch::add(GLuint texture, const glm::vec2& pos, const glm::vec2& size, float depth, bool isOpaque)
+	{
+		add(texture, 0, pos, size, depth, isOpaque);
+	}
+
+	void SpriteBatch::add(GLuint texture, GLuint normalMap, const glm::vec2& pos, const glm::vec2& size, float depth, bool isOpaque)
+	{
+		Sprite sprite;
+		sprite.texture = texture;
+		sprite.normalMap = normalMap;
+		sprite.pos = pos;
+		sprite.size = size;
+		// outside [0, 1] the quad would be clipped by the near or far plane
+		sprite.depth = glm::clamp(depth, 0.0f, 1.0f);
+		sprite.isOpaque = isOpaque;
 
-		static GLuint vertexBuffer;
-		glGenBuffers(1, &vertexBuffer);
-		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		m_sprites.push_back(sprite);
+	}
 
-		static float verticies[] =
+	void SpriteBatch::sortSprites()
+	{
+		m_order.resize(m_sprites.size());
+		for(uint32 i = 0; i < m_order.size(); i++)
+			m_order[i] = i;
+
+		if(!m_isDepthSortingEnabled)
+			return;
+
+		// opaque front-to-back (grouped by texture on equal depth),
+		// then translucent back-to-front keeping submission order on ties
+		std::stable_sort(m_order.begin(), m_order.end(), [this](uint32 a, uint32 b)
 		{
-           0.0f, 0.0f, 0.0f, 0.0f,
-           0.0f, 1.0f, 0.0f, 1.0f,
-           1.0f, 1.0f, 1.0f, 1.0f,
+			const Sprite& lhs = m_sprites[a];
+			const Sprite& rhs = m_sprites[b];
 
-           1.0f, 1.0f, 1.0f, 1.0f,
-           1.0f, 0.0f, 1.0f, 0.0f,
-           0.0f, 0.0f, 0.0f, 0.0f
-		};
+			if(lhs.isOpaque != rhs.isOpaque)
+				return lhs.isOpaque;
+
+			if(lhs.isOpaque)
+			{
+				if(lhs.depth != rhs.depth)
+					return lhs.depth < rhs.depth;
+				if(lhs.texture != rhs.texture)
+					return lhs.texture < rhs.texture;
+				return lhs.normalMap < rhs.normalMap;
+			}
+
+			return lhs.depth > rhs.depth;
+		});
+	}
+
+	void SpriteBatch::appendQuad(const Sprite& sprite)
+	{
+		float x0 = sprite.pos.x;
+		float y0 = sprite.pos.y;
+		float x1 = sprite.pos.x + sprite.size.x;
+		float y1 = sprite.pos.y + sprite.size.y;
+		float z = m_isDepthSortingEnabled ? -sprite.depth : 0.0f;
+
+		m_vertices.push_back({ x0, y0, z, 0.0f, 0.0f });
+		m_vertices.push_back({ x0, y1, z, 0.0f, 1.0f });
+		m_vertices.push_back({ x1, y1, z, 1.0f, 1.0f });
+
+		m_vertices.push_back({ x1, y1, z, 1.0f, 1.0f });
+		m_vertices.push_back({ x1, y0, z, 1.0f, 0.0f });
+		m_vertices.push_back({ x0, y0, z, 0.0f, 0.0f });
+	}
+
+	void SpriteBatch::prepare()
+	{
+		m_vertices.clear();
+		m_drawCommands.clear();
+		m_stats = SpriteBatchStats();
+
+		sortSprites();
+
+		for(uint32 index : m_order)
+		{
+			const Sprite& sprite = m_sprites[index];
+			bool isOpaque = m_isDepthSortingEnabled && sprite.isOpaque;
+
+			if(m_drawCommands.empty() || m_drawCommands.back().texture != sprite.texture ||
+			   m_drawCommands.back().normalMap != sprite.normalMap || m_drawCommands.back().isOpaque != isOpaque)
+			{
+				m_drawCommands.push_back({ sprite.texture, sprite.normalMap, (uint32)m_vertices.size(), 0, isOpaque });
+			}
+
+			appendQuad(sprite);
+			m_drawCommands.back().count += 6;
+
+			if(sprite.isOpaque)
+				m_stats.opaqueSprites++;
+			else
+				m_stats.translucentSprites++;
+		}
+
+		m_stats.sprites = (uint32)m_sprites.size();
+
+		if(m_isOverdrawCountingEnabled)
+			countOverdraw();
+	}
+
+	void SpriteBatch::flush()
+	{
+		if(m_vertices.empty())
+			return;
+
+		if(!m_isInitialized)
+			initGL();
+
+		OverdrawHeatmap& heatmap = OverdrawHeatmap::getOverdrawHeatmap();
+		bool isHeatmapEnabled = heatmap.isEnabled();
+		bool isLit = !isHeatmapEnabled && m_lightCuller != nullptr;
+
+		if(isHeatmapEnabled)
+		{
+			heatmap.bindTarget(m_viewportWidth, m_viewportHeight);
+			glUseProgram(m_heatmapProgram);
+			glUniformMatrix4fv(m_heatmapMvpLocation, 1, GL_FALSE, glm::value_ptr(m_modelViewProj));
+		}
+		else if(isLit)
+		{
+			glUseProgram(m_litProgram);
+			glUniformMatrix4fv(m_litMvpLocation, 1, GL_FALSE, glm::value_ptr(m_modelViewProj));
+			m_lightCuller->bind(m_litProgram);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		else
+		{
+			glUseProgram(m_shaderProgram);
+			glUniformMatrix4fv(m_mvpLocation, 1, GL_FALSE, glm::value_ptr(m_modelViewProj));
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+
+		glBindVertexArray(m_vertexArray);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+		// orphan last frame's storage so the driver doesn't wait on it
+		glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(SpriteVertex), m_vertices.data());
+
+		glActiveTexture(GL_TEXTURE0);
+
+		if(m_isDepthSortingEnabled)
+		{
+			glEnable(GL_DEPTH_TEST);
+			glDepthFunc(GL_LEQUAL);
+		}
+
+		bool isOpaquePass = false;
+		bool isFirstCommand = true;
+		for(auto& command : m_drawCommands)
+		{
+			if(isFirstCommand || command.isOpaque != isOpaquePass)
+			{
+				isOpaquePass = command.isOpaque;
+				isFirstCommand = false;
+
+				glDepthMask(isOpaquePass ? GL_TRUE : GL_FALSE);
+				// the heatmap accumulates additively in both passes
+				if(isOpaquePass && !isHeatmapEnabled)
+					glDisable(GL_BLEND);
+				else
+					glEnable(GL_BLEND);
+			}
+
+			GLuint texture = command.texture;
+			GLuint normalMap = command.normalMap;
+			if(m_textureResolver)
+			{
+				texture = m_textureResolver(texture);
+				normalMap = normalMap ? m_textureResolver(normalMap) : 0;
+				// still loading, drawn once it's resident
+				if(texture == 0)
+					continue;
+			}
+
+			if(isLit)
+			{
+				glActiveTexture(GL_TEXTURE1);
+				glBindTexture(GL_TEXTURE_2D, normalMap ? normalMap : m_flatNormalTexture);
+				glActiveTexture(GL_TEXTURE0);
+			}
 
-		glBufferData(GL_ARRAY_BUFFER, sizeof(verticies), verticies, GL_STATIC_DRAW);
-
-		static const GLchar* vertexShaderSource = {
-        R"(
-            #version 300 es
-            
-            layout (location = 0) in vec2 pos;
-            layout (location = 1) in vec2 uvIn;
-            
-            uniform mat4 mvp;
-            
-            out vec2 uv;
-            
-            void main()
-            {
-                gl_Position = mvp * vec4(pos, 0, 1.0f);
-                uv = uvIn;
-            }
-        )"
-    };
-    
-    static GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-    
-    static const GLchar* fragmentShaderSource = {
-        R"(
-            #version 300 es
-            
-            precision mediump float;
-            
-            out vec4 color;
-            in vec2 uv;
-            
-            uniform sampler2D tex;
-            
-            void main()
-            {
-                color = texture(tex, uv);
-            }
-        )"
-    };
-    
-    static GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
-    
-    static GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    
-    glUseProgram(shaderProgram);
-
-    static glm::mat4 model = glm::mat4(1);
-    model = glm::translate(model, glm::vec3(pos, 0.0f));
-
-    model = glm::scale(model, glm::vec3(size, 0.0f));
-
-    m_modelViewProj = m_modelViewProj * model;
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, nullptr);
-    
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 4, (void*)(sizeof(float) * 2));
-    
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "mvp"), 1, GL_FALSE, glm::value_ptr(m_modelViewProj));
-
-    registerBatch(texture, vertexArray, vertexBuffer, shaderProgram);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glDrawArrays(GL_TRIANGLES, command.first, command.count);
+			m_stats.drawCalls++;
+		}
+
+		glDepthMask(GL_TRUE);
+		glDisable(GL_DEPTH_TEST);
+		glDisable(GL_BLEND);
+		glBindVertexArray(0);
+
+		if(isHeatmapEnabled)
+			heatmap.unbindTarget();
 	}
 
 	void SpriteBatch::end()
 	{
-		glBindVertexArray(m_batches[0].vertexArray);
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		prepare();
+		flush();
+	}
+
+	void SpriteBatch::countOverdraw()
+	{
+		uint32 columns = (m_viewportWidth + OVERDRAW_CELL_SIZE - 1) / OVERDRAW_CELL_SIZE;
+		uint32 rows = (m_viewportHeight + OVERDRAW_CELL_SIZE - 1) / OVERDRAW_CELL_SIZE;
+		m_overdrawDepth.assign(columns * rows, FLT_MAX);
+
+		// walks the sprites in draw order and mimics the GL_LEQUAL depth test
+		uint64 shadedCells = 0;
+		for(uint32 index : m_order)
+		{
+			const Sprite& sprite = m_sprites[index];
+
+			int32 x0 = std::max(0, (int32)std::floor(sprite.pos.x / OVERDRAW_CELL_SIZE));
+			int32 y0 = std::max(0, (int32)std::floor(sprite.pos.y / OVERDRAW_CELL_SIZE));
+			int32 x1 = std::min((int32)columns, (int32)std::ceil((sprite.pos.x + sprite.size.x) / OVERDRAW_CELL_SIZE));
+			int32 y1 = std::min((int32)rows, (int32)std::ceil((sprite.pos.y + sprite.size.y) / OVERDRAW_CELL_SIZE));
+			if(x0 >= x1 || y0 >= y1)
+				continue;
+
+			if(!m_isDepthSortingEnabled)
+			{
+				shadedCells += (uint64)(x1 - x0) * (y1 - y0);
+				continue;
+			}
+
+			for(int32 y = y0; y < y1; y++)
+			{
+				float* cell = &m_overdrawDepth[y * columns + x0];
+				for(int32 x = x0; x < x1; x++, cell++)
+				{
+					if(sprite.depth > *cell)
+						continue;
+
+					shadedCells++;
+					if(sprite.isOpaque)
+						*cell = sprite.depth;
+				}
+			}
+		}
+
+		m_stats.fragmentsShaded = shadedCells * OVERDRAW_CELL_SIZE * OVERDRAW_CELL_SIZE;
+		m_stats.screenPixels = (uint64)m_viewportWidth * m_viewportHeight;
+		// a 0x0 viewport, e.g. a drawable of 0 height, shades nothing
+		m_stats.overdraw = m_stats.screenPixels > 0 ? (float)m_stats.fragmentsShaded / m_stats.screenPixels : 0.0f;
 	}
-}
\ No newline at end of file
+}
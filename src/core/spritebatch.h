@@ -4,30 +4,123 @@
 #include <map>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
+#include "common.h"
 
 namespace Dawn
 {
-	struct Batch
+	struct Sprite
 	{
 		GLuint texture;
-		GLuint vertexArray;
-		GLuint vertexBuffer;
-		GLuint shaderProgram;
+		// 0 uses a flat normal when lighting is enabled
+		GLuint normalMap;
+		glm::vec2 pos;
+		glm::vec2 size;
+		// 0 is nearest to the camera, 1 furthest away
+		float depth;
+		bool isOpaque;
 	};
 
+	struct SpriteVertex
+	{
+		float x, y, z;
+		float u, v;
+	};
+
+	struct SpriteDrawCommand
+	{
+		GLuint texture;
+		GLuint normalMap;
+		uint32 first;
+		uint32 count;
+		bool isOpaque;
+	};
+
+	struct SpriteBatchStats
+	{
+		uint32 sprites{};
+		uint32 opaqueSprites{};
+		uint32 translucentSprites{};
+		uint32 drawCalls{};
+
+		// software estimate, only filled while overdraw counting is enabled
+		uint64 fragmentsShaded{};
+		uint64 screenPixels{};
+		float overdraw{};
+	};
+
+	class TiledLightCuller;
+
+	// Maps the texture ids stored in sprites to GL textures at flush time.
+	typedef GLuint (*TextureResolver)(GLuint texture);
+
 	class SpriteBatch
 	{
-		std::vector<Batch> m_batches{};
+		std::vector<Sprite> m_sprites{};
+		std::vector<uint32> m_order{};
+		std::vector<SpriteVertex> m_vertices{};
+		std::vector<SpriteDrawCommand> m_drawCommands{};
 
 		glm::mat4 m_modelViewProj{1.0f};
+		uint32 m_viewportWidth{800};
+		uint32 m_viewportHeight{600};
+
+		GLuint m_vertexArray{};
+		GLuint m_vertexBuffer{};
+		GLuint m_shaderProgram{};
+		GLint m_mvpLocation{-1};
+		GLuint m_heatmapProgram{};
+		GLint m_heatmapMvpLocation{-1};
+		GLuint m_litProgram{};
+		GLint m_litMvpLocation{-1};
+		GLuint m_flatNormalTexture{};
+		bool m_isInitialized{};
+
+		bool m_isDepthSortingEnabled{};
+		bool m_isOverdrawCountingEnabled{};
+		TiledLightCuller* m_lightCuller{};
+		TextureResolver m_textureResolver{};
+		std::vector<float> m_overdrawDepth{};
 
-		void registerBatch(GLuint texture, GLuint vertexArray, GLuint vertexBuffer, GLuint shaderProgram);
+		SpriteBatchStats m_stats{};
+
+		void initGL();
+		void sortSprites();
+		void appendQuad(const Sprite& sprite);
+		void countOverdraw();
 	public:
 		SpriteBatch();
 		~SpriteBatch();
 
 		void begin();
 		void add(GLuint texture, const glm::vec2& pos, const glm::vec2& size);
+		void add(GLuint texture, const glm::vec2& pos, const glm::vec2& size, float depth, bool isOpaque);
+		void add(GLuint texture, GLuint normalMap, const glm::vec2& pos, const glm::vec2& size, float depth, bool isOpaque);
 		void end();
+
+		// CPU half of end(): sorts the sprites and builds the vertex stream.
+		void prepare();
+		// GL half of end(): uploads the vertex stream and issues the draws.
+		void flush();
+
+		void setViewport(uint32 width, uint32 height);
+
+		// Draws opaque sprites front-to-back with depth writes, then translucent
+		// ones back-to-front with depth testing only. Needs a depth buffer.
+		// When disabled sprites are drawn in submission order.
+		inline void setDepthSorting(bool isEnabled) { m_isDepthSortingEnabled = isEnabled; }
+		inline bool isDepthSortingEnabled() const { return m_isDepthSortingEnabled; }
+
+		// Rasterizes the batch on a coarse CPU grid to estimate shaded fragments.
+		inline void setOverdrawCounting(bool isEnabled) { m_isOverdrawCountingEnabled = isEnabled; }
+
+		// Shades the sprites with the tile light lists of the culler, which has to
+		// be uploaded before flush(). nullptr goes back to unlit drawing.
+		inline void setLighting(TiledLightCuller* lightCuller) { m_lightCuller = lightCuller; }
+
+		// Lets sprites be recorded with TextureManager handles off the GL
+		// thread, they're resolved to GL textures when flushed.
+		inline void setTextureResolver(TextureResolver resolver) { m_textureResolver = resolver; }
+
+		inline const SpriteBatchStats& getStats() const { return m_stats; }
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,216 @@
+#include "timer_wheel.h"
+#include <algorithm>
+
+namespace Dawn
+{
+	TimerWheel::TimerWheel()
+	{
+		std::fill(m_buckets, m_buckets + LEVELS * SLOTS, NIL);
+	}
+
+	uint32 TimerWheel::allocate()
+	{
+		if(!m_freeTimers.empty())
+		{
+			uint32 index = m_freeTimers.back();
+			m_freeTimers.pop_back();
+			return index;
+		}
+
+		m_timers.emplace_back();
+		return (uint32)(m_timers.size() - 1);
+	}
+
+	void TimerWheel::release(uint32 index)
+	{
+		Timer& timer = m_timers[index];
+		timer.isActive = false;
+		timer.callback = nullptr;
+		// stale handles stop matching, 0 stays reserved for INVALID_HANDLE
+		if(++timer.generation == 0)
+			timer.generation = 1;
+
+		m_freeTimers.push_back(index);
+		m_activeCount--;
+	}
+
+	void TimerWheel::link(uint32 index)
+	{
+		Timer& timer = m_timers[index];
+
+		// the level is picked by how far away the expiry is, the slot by its bits at that level
+		uint64 delta = timer.expiry - m_currentTick;
+		uint32 level = 0;
+		while(level < LEVELS - 1 && delta >= (uint64)1 << (SLOT_BITS * (level + 1)))
+			level++;
+
+		uint32 slot = (uint32)(timer.expiry >> (SLOT_BITS * level)) & SLOT_MASK;
+		uint32 bucket = level * SLOTS + slot;
+
+		timer.prev = NIL;
+		timer.next = m_buckets[bucket];
+		if(timer.next != NIL)
+			m_timers[timer.next].prev = index;
+		m_buckets[bucket] = index;
+		timer.bucket = bucket;
+	}
+
+	void TimerWheel::unlink(uint32 index)
+	{
+		Timer& timer = m_timers[index];
+
+		if(timer.prev != NIL)
+			m_timers[timer.prev].next = timer.next;
+		else
+			m_buckets[timer.bucket] = timer.next;
+
+		if(timer.next != NIL)
+			m_timers[timer.next].prev = timer.prev;
+
+		timer.prev = NIL;
+		timer.next = NIL;
+		timer.bucket = NIL;
+	}
+
+	void TimerWheel::cascade(uint32 level)
+	{
+		uint32 bucket = level * SLOTS + ((uint32)(m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+		uint32 index = m_buckets[bucket];
+		m_buckets[bucket] = NIL;
+
+		while(index != NIL)
+		{
+			uint32 next = m_timers[index].next;
+			link(index);
+			m_stats.cascaded++;
+			index = next;
+		}
+	}
+
+	TimerHandle TimerWheel::schedule(uint64 delay, const Callback& callback)
+	{
+		return scheduleRepeating(delay, 0, callback);
+	}
+
+	TimerHandle TimerWheel::scheduleRepeating(uint64 delay, uint32 period, const Callback& callback)
+	{
+		// the top level reaches 2^32 ticks ahead
+		const uint64 maxDelay = ((uint64)1 << (SLOT_BITS * LEVELS)) - 1;
+
+		uint32 index = allocate();
+		Timer& timer = m_timers[index];
+		// the current tick is already processed, so a delay of 0 or 1 both mean the next one
+		timer.expiry = m_currentTick + (std::min(std::max<uint64>(delay, 1), maxDelay) - 1);
+		timer.period = period;
+		timer.isActive = true;
+		timer.callback = callback;
+		m_activeCount++;
+
+		link(index);
+		return makeHandle(index, timer.generation);
+	}
+
+	bool TimerWheel::cancel(TimerHandle handle)
+	{
+		if(!isActive(handle))
+			return false;
+
+		uint32 index = (uint32)handle;
+		// timers waiting in the expired batch are skipped by their generation
+		if(m_timers[index].bucket != NIL)
+			unlink(index);
+
+		release(index);
+		return true;
+	}
+
+	bool TimerWheel::isActive(TimerHandle handle) const
+	{
+		uint32 index = (uint32)handle;
+		uint32 generation = (uint32)(handle >> 32);
+
+		return index < m_timers.size() && m_timers[index].generation == generation && m_timers[index].isActive;
+	}
+
+	void TimerWheel::advance(uint64 now)
+	{
+		m_stats.fired = 0;
+		m_stats.cascaded = 0;
+		m_stats.ticks = 0;
+
+		// nothing to hit on the way, jump straight to now
+		if(m_activeCount == 0 && m_currentTick <= now)
+			m_currentTick = now + 1;
+
+		while(m_currentTick <= now)
+		{
+			// a level cascades whenever all the bits below it wrapped, coarsest first
+			uint32 cascadeLevels = 0;
+			while(cascadeLevels < LEVELS - 1 && (m_currentTick & (((uint64)1 << (SLOT_BITS * (cascadeLevels + 1))) - 1)) == 0)
+				cascadeLevels++;
+			for(uint32 level = cascadeLevels; level > 0; level--)
+				cascade(level);
+
+			uint32 bucket = (uint32)m_currentTick & SLOT_MASK;
+			uint32 index = m_buckets[bucket];
+			m_buckets[bucket] = NIL;
+
+			while(index != NIL)
+			{
+				Timer& timer = m_timers[index];
+				uint32 next = timer.next;
+				timer.prev = NIL;
+				timer.next = NIL;
+				timer.bucket = NIL;
+
+				m_expired.push_back({ index, timer.generation });
+				index = next;
+			}
+
+			m_currentTick++;
+			m_stats.ticks++;
+		}
+
+		fireExpired();
+		m_stats.activeTimers = m_activeCount;
+	}
+
+	void TimerWheel::fireExpired()
+	{
+		for(size_t i = 0; i < m_expired.size(); i++)
+		{
+			Expired expired = m_expired[i];
+			if(m_timers[expired.index].generation != expired.generation || !m_timers[expired.index].isActive)
+				continue;
+
+			// moved out, a callback scheduling timers may grow m_timers under us
+			Callback callback = std::move(m_timers[expired.index].callback);
+			uint32 period = m_timers[expired.index].period;
+
+			if(period == 0)
+			{
+				release(expired.index);
+				callback();
+				m_stats.fired++;
+				continue;
+			}
+
+			callback();
+			m_stats.fired++;
+
+			Timer& timer = m_timers[expired.index];
+			if(timer.generation != expired.generation || !timer.isActive)
+				continue;
+
+			// keep the phase, skipping the periods a long frame missed
+			timer.expiry += period;
+			if(timer.expiry < m_currentTick)
+				timer.expiry += (m_currentTick - timer.expiry + period - 1) / period * period;
+
+			timer.callback = std::move(callback);
+			link(expired.index);
+		}
+
+		m_expired.clear();
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "common.h"
+
+namespace Dawn
+{
+	// generation in the high half, slot index in the low half, 0 is never issued
+	typedef uint64 TimerHandle;
+
+	struct TimerWheelStats
+	{
+		uint32 activeTimers{};
+		// during the last advance()
+		uint32 fired{};
+		uint32 cascaded{};
+		uint32 ticks{};
+	};
+
+	// Hierarchical timing wheel: four levels of 256 slots, each level 256
+	// times coarser than the one below. Timers sit in intrusive lists, so
+	// scheduling and cancelling are O(1); a tick empties one slot and now and
+	// then cascades a coarse slot into the finer levels. Expired timers are
+	// collected over the whole advance() and fired together afterwards.
+	class TimerWheel
+	{
+	public:
+		typedef std::function<void()> Callback;
+
+		static const TimerHandle INVALID_HANDLE = 0;
+
+	private:
+		static const uint32 LEVELS = 4;
+		static const uint32 SLOT_BITS = 8;
+		static const uint32 SLOTS = 1 << SLOT_BITS;
+		static const uint32 SLOT_MASK = SLOTS - 1;
+		static const uint32 NIL = 0xffffffff;
+
+		struct Timer
+		{
+			uint64 expiry{};
+			uint32 period{};
+			uint32 generation{1};
+			uint32 prev{NIL};
+			uint32 next{NIL};
+			// list head the timer is linked into, NIL while free or firing
+			uint32 bucket{NIL};
+			bool isActive{};
+			Callback callback{};
+		};
+
+		struct Expired
+		{
+			uint32 index;
+			uint32 generation;
+		};
+
+		std::vector<Timer> m_timers{};
+		std::vector<uint32> m_freeTimers{};
+		uint32 m_buckets[LEVELS * SLOTS];
+		std::vector<Expired> m_expired{};
+
+		// next tick to be processed, the clock starts at tick 0
+		uint64 m_currentTick{1};
+		uint32 m_activeCount{};
+
+		TimerWheelStats m_stats{};
+
+		uint32 allocate();
+		void release(uint32 index);
+		void link(uint32 index);
+		void unlink(uint32 index);
+		void cascade(uint32 level);
+		void fireExpired();
+
+		static inline TimerHandle makeHandle(uint32 index, uint32 generation) { return (uint64)generation << 32 | index; }
+
+		DAWN_NULL_COPY_AND_ASSIGN(TimerWheel)
+	public:
+		TimerWheel();
+		~TimerWheel() {}
+
+		// Delays are in ticks of the clock passed to advance(); a delay of 0
+		// fires on the next advance. Repeating timers keep their phase, they
+		// don't drift when a frame is late.
+		TimerHandle schedule(uint64 delay, const Callback& callback);
+		TimerHandle scheduleRepeating(uint64 delay, uint32 period, const Callback& callback);
+		// Safe from inside a callback, also for timers due in the same batch.
+		bool cancel(TimerHandle handle);
+		bool isActive(TimerHandle handle) const;
+
+		// Processes every tick up to and including now, then fires what expired.
+		void advance(uint64 now);
+
+		// Last tick processed.
+		inline uint64 getCurrentTick() const { return m_currentTick - 1; }
+		inline uint32 getActiveCount() const { return m_activeCount; }
+		inline const TimerWheelStats& getStats() const { return m_stats; }
+	};
+}
@@ -1,6 +1,7 @@
 #include "core/log.h"
 #include "core/app_state.h"
 #include <glm/glm.hpp>
+#include <cstring>
 
 int main(int argc, char** argv)
 {
@@ -10,6 +11,20 @@ int main(int argc, char** argv)
    
     auto app = Dawn::AppState::create();
     app->initWindow("Dawn", 840, 640);
+
+    // --record <file> captures this run's input, --replay <file> plays one back and quits
+    for(int i = 1; i + 1 < argc; i++)
+    {
+        if(std::strcmp(argv[i], "--record") == 0)
+            app->recordInput(argv[++i]);
+        else if(std::strcmp(argv[i], "--replay") == 0 && !app->replayInput(argv[++i], true))
+        {
+            // a benchmark run without its recording would measure idle frames
+            delete app;
+            return EXIT_FAILURE;
+        }
+    }
+
     app->execute();
     
     delete app;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "core/common.h"
+#include "core/log.h"
+
+namespace Dawn
+{
+	typedef std::chrono::steady_clock BenchmarkClock;
+
+	inline double getElapsedMs(BenchmarkClock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(BenchmarkClock::now() - start).count();
+	}
+
+	// Nearest rank, reorders the samples.
+	inline float getPercentile(std::vector<float>& samples, float fraction)
+	{
+		if(samples.empty())
+			return 0.0f;
+
+		size_t rank = (size_t)(fraction * (samples.size() - 1) + 0.5f);
+		std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+		return samples[rank];
+	}
+
+	// Keeps the compiler from dropping work whose result is unused.
+	template <typename T>
+	inline void keepAlive(const T& value)
+	{
+		static volatile T sink;
+		sink = value;
+	}
+}
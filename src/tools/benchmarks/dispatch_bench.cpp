@@ -0,0 +1,130 @@
+#include <memory>
+#include <vector>
+#include "core/events/events.h"
+#include "benchmark.h"
+
+using namespace Dawn;
+
+// One million mouse moves dispatched to 1000 listeners of which 10 care
+// about them. Once with every listener subscribed to every type through
+// shipEvent(), the way the dispatcher used to deliver, and once with each
+// listener subscribed only to the type it handles.
+
+namespace
+{
+	const uint32 EVENT_COUNT = 1000000;
+	const uint32 LISTENER_COUNT = 1000;
+	const uint32 INTERESTED_COUNT = 10;
+
+	class MoveListener : public EventListener
+	{
+	public:
+		uint64 moves{};
+		int64 sum{};
+
+		void onMouseMove(MouseMoveEvent& e) override
+		{
+			moves++;
+			sum += e.posX;
+		}
+	};
+
+	// the other 990, they only handle keys
+	class KeyListener : public EventListener
+	{
+	public:
+		int64 sum{};
+
+		void onKeyDown(KeyDownEvent& e) override
+		{
+			sum += e.keyCode;
+		}
+	};
+
+	struct Listeners
+	{
+		std::vector<std::unique_ptr<MoveListener>> moveListeners;
+		std::vector<std::unique_ptr<KeyListener>> keyListeners;
+
+		Listeners()
+		{
+			for(uint32 i = 0; i < INTERESTED_COUNT; i++)
+				moveListeners.emplace_back(new MoveListener());
+			for(uint32 i = INTERESTED_COUNT; i < LISTENER_COUNT; i++)
+				keyListeners.emplace_back(new KeyListener());
+		}
+
+		~Listeners()
+		{
+			EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+			for(auto& listener : moveListeners)
+				eventDispatcher.removeEventListener(listener.get());
+			for(auto& listener : keyListeners)
+				eventDispatcher.removeEventListener(listener.get());
+		}
+	};
+
+	// Dispatches the moves, false if the interested listeners didn't get each exactly once.
+	bool run(const char* name, Listeners& listeners, double& elapsedMs)
+	{
+		EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+		MouseMoveEvent event;
+
+		BenchmarkClock::time_point start = BenchmarkClock::now();
+		for(uint32 i = 0; i < EVENT_COUNT; i++)
+		{
+			event.posX = (int32)i;
+			event.deltaX = 1;
+			eventDispatcher.dispatchEvent(event);
+		}
+		elapsedMs = getElapsedMs(start);
+
+		bool isCorrect = true;
+		for(auto& listener : listeners.moveListeners)
+		{
+			isCorrect = isCorrect && listener->moves == EVENT_COUNT;
+			keepAlive(listener->sum);
+		}
+
+		DAWN_INFO("{:<9} {:7.1f} ms  {:5.1f} ns per event", name, elapsedMs, elapsedMs * 1e6 / EVENT_COUNT);
+		return isCorrect;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+	EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+
+	DAWN_INFO("{} mouse moves, {} listeners, {} of them interested", EVENT_COUNT, LISTENER_COUNT, INTERESTED_COUNT);
+
+	double catchAllMs = 0.0;
+	double perTypeMs = 0.0;
+	bool isCorrect = true;
+	{
+		// every listener is shipped every event and filters it in shipEvent()
+		Listeners listeners;
+		for(auto& listener : listeners.moveListeners)
+			eventDispatcher.addEventListener(listener.get());
+		for(auto& listener : listeners.keyListeners)
+			eventDispatcher.addEventListener(listener.get());
+		isCorrect = run("catch-all", listeners, catchAllMs) && isCorrect;
+	}
+	{
+		Listeners listeners;
+		for(auto& listener : listeners.moveListeners)
+			eventDispatcher.addEventListener(listener.get(), Event::MOUSE_MOVE);
+		for(auto& listener : listeners.keyListeners)
+			eventDispatcher.addEventListener(listener.get(), Event::KEY_DOWN);
+		isCorrect = run("per type", listeners, perTypeMs) && isCorrect;
+	}
+
+	if(!isCorrect)
+	{
+		DAWN_ERROR("the interested listeners didn't get every move exactly once");
+		return 1;
+	}
+
+	DAWN_INFO("per type subscriptions {:.1f}x faster", catchAllMs / perTypeMs);
+	return 0;
+}
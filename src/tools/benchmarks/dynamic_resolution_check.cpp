@@ -0,0 +1,71 @@
+#include "core/graphics/dynamic_resolution.h"
+#include "benchmark.h"
+
+using namespace Dawn;
+
+// Feeds the dynamic resolution controller frame costs from a fill-bound
+// model, a fixed part plus a part growing with the pixel count, through a
+// light, a heavy and again a light load. The scale has to stay at 1.0, drop
+// under the heavy load until the frames fit the budget, then climb back to
+// 1.0 once the load goes away. No GL is needed, only the controller runs.
+
+namespace
+{
+	const float TARGET_MS = 1000.0f / 60.0f;
+	const float FIXED_MS = 2.0f;
+	// fill cost of a frame at scale 1.0
+	const float LIGHT_FILL_MS = 6.0f;
+	const float HEAVY_FILL_MS = 22.0f;
+	const uint32 PHASE_FRAMES = 300;
+
+	float runPhase(DynamicResolution& dynamicResolution, float fillMs)
+	{
+		for(uint32 i = 0; i < PHASE_FRAMES; i++)
+		{
+			float scale = dynamicResolution.getStats().scale;
+			dynamicResolution.addFrameTime(FIXED_MS + fillMs * scale * scale);
+		}
+
+		const DynamicResolutionStats& stats = dynamicResolution.getStats();
+		DAWN_INFO("fill {:4.1f} ms  scale {:.2f}  smoothed {:5.2f} ms  {} increases  {} decreases",
+		          fillMs, stats.scale, stats.frameMs, stats.increases, stats.decreases);
+		return stats.scale;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+
+	DynamicResolution dynamicResolution;
+	dynamicResolution.setTargetFrameTime(TARGET_MS);
+	dynamicResolution.setEnabled(true);
+
+	float lightScale = runPhase(dynamicResolution, LIGHT_FILL_MS);
+	float heavyScale = runPhase(dynamicResolution, HEAVY_FILL_MS);
+	float heavyMs = dynamicResolution.getStats().frameMs;
+	float recoveredScale = runPhase(dynamicResolution, LIGHT_FILL_MS);
+
+	bool isCorrect = true;
+	if(lightScale != 1.0f)
+	{
+		DAWN_ERROR("the scale dropped to {:.2f} under a load that fits the budget", lightScale);
+		isCorrect = false;
+	}
+	if(heavyScale >= 1.0f || heavyMs > TARGET_MS * 1.05f)
+	{
+		DAWN_ERROR("the heavy load left the scale at {:.2f} and frames at {:.2f} ms", heavyScale, heavyMs);
+		isCorrect = false;
+	}
+	if(recoveredScale != 1.0f)
+	{
+		DAWN_ERROR("the scale stayed at {:.2f} after the load went away", recoveredScale);
+		isCorrect = false;
+	}
+
+	if(!isCorrect)
+		return 1;
+
+	DAWN_INFO("the scale dropped under load and came back to 1.0");
+	return 0;
+}
@@ -0,0 +1,169 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "core/events/event_queue.h"
+#include "benchmark.h"
+
+using namespace Dawn;
+
+// Throughput and latency of the event rings. Throughput pushes events as
+// fast as the producers can while one consumer pops them; latency paces a
+// single producer and timestamps every event from push to pop. Both rings
+// have the EventQueue's capacities. On a machine with fewer cores than
+// threads the numbers mostly show the scheduler.
+
+namespace
+{
+	const uint32 PLATFORM_CAPACITY = 4096;
+	const uint32 POST_CAPACITY = 1024;
+	const uint32 THROUGHPUT_EVENTS = 4000000;
+	const uint32 LATENCY_EVENTS = 100000;
+	// between two pushes of the latency run
+	const std::chrono::microseconds LATENCY_INTERVAL{20};
+
+	struct StampedEvent
+	{
+		int64 sentNs;
+		QueuedEvent event;
+	};
+
+	inline int64 getNowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(BenchmarkClock::now().time_since_epoch()).count();
+	}
+
+	inline QueuedEvent makeEvent(uint32 index)
+	{
+		QueuedEvent event{};
+		event.type = Event::MOUSE_MOVE;
+		event.mouseMove.posX = (int32)index;
+		event.mouseMove.deltaX = 1;
+		return event;
+	}
+
+	// Pops everything the producers push, false if an event went missing or was duplicated.
+	template <typename Queue>
+	bool consume(Queue& queue, uint32 count, uint64 expectedSum)
+	{
+		uint64 sum = 0;
+		QueuedEvent event;
+		for(uint32 received = 0; received < count; )
+		{
+			if(!queue.pop(event))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			sum += (uint32)event.mouseMove.posX;
+			received++;
+		}
+		return sum == expectedSum;
+	}
+
+	template <typename Queue>
+	bool measureThroughput(const char* name, Queue& queue, uint32 producerCount)
+	{
+		uint32 perProducer = THROUGHPUT_EVENTS / producerCount;
+		uint32 count = perProducer * producerCount;
+		uint64 expectedSum = (uint64)producerCount * perProducer * (perProducer - 1) / 2;
+
+		BenchmarkClock::time_point start = BenchmarkClock::now();
+		std::vector<std::thread> producers;
+		for(uint32 p = 0; p < producerCount; p++)
+		{
+			producers.emplace_back([&queue, perProducer]()
+			{
+				for(uint32 i = 0; i < perProducer; i++)
+				{
+					while(!queue.push(makeEvent(i)))
+						std::this_thread::yield();
+				}
+			});
+		}
+
+		bool isCorrect = consume(queue, count, expectedSum);
+		for(auto& producer : producers)
+			producer.join();
+		double elapsedMs = getElapsedMs(start);
+
+		DAWN_INFO("{:<4} {} producer{}  {:6.1f} M events/s  {:5.1f} ns per event", name, producerCount,
+		          producerCount > 1 ? "s" : " ", count / elapsedMs / 1000.0, elapsedMs * 1e6 / count);
+		return isCorrect;
+	}
+
+	template <typename Queue>
+	void measureLatency(const char* name, Queue& queue)
+	{
+		std::vector<float> latencyUs;
+		latencyUs.reserve(LATENCY_EVENTS);
+
+		std::thread producer([&queue]()
+		{
+			BenchmarkClock::time_point next = BenchmarkClock::now();
+			for(uint32 i = 0; i < LATENCY_EVENTS; i++)
+			{
+				// paced, so the ring stays near empty and only the handoff is measured
+				while(BenchmarkClock::now() < next)
+					std::this_thread::yield();
+				next += LATENCY_INTERVAL;
+
+				StampedEvent stamped;
+				stamped.event = makeEvent(i);
+				stamped.sentNs = getNowNs();
+				while(!queue.push(stamped))
+					std::this_thread::yield();
+			}
+		});
+
+		StampedEvent stamped;
+		while(latencyUs.size() < LATENCY_EVENTS)
+		{
+			if(!queue.pop(stamped))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			latencyUs.push_back((getNowNs() - stamped.sentNs) / 1000.0f);
+		}
+		producer.join();
+
+		float maxUs = *std::max_element(latencyUs.begin(), latencyUs.end());
+		float p50 = getPercentile(latencyUs, 0.50f);
+		float p99 = getPercentile(latencyUs, 0.99f);
+		DAWN_INFO("{:<4} latency  p50 {:7.2f} us  p99 {:7.2f} us  max {:8.2f} us", name, p50, p99, maxUs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+	DAWN_INFO("{} cores", std::thread::hardware_concurrency());
+
+	bool isCorrect = true;
+	{
+		SpscQueue<QueuedEvent> queue(PLATFORM_CAPACITY);
+		isCorrect = measureThroughput("SPSC", queue, 1) && isCorrect;
+	}
+	for(uint32 producerCount = 1; producerCount <= 4; producerCount *= 2)
+	{
+		MpscQueue<QueuedEvent> queue(POST_CAPACITY);
+		isCorrect = measureThroughput("MPSC", queue, producerCount) && isCorrect;
+	}
+
+	{
+		SpscQueue<StampedEvent> queue(PLATFORM_CAPACITY);
+		measureLatency("SPSC", queue);
+	}
+	{
+		MpscQueue<StampedEvent> queue(POST_CAPACITY);
+		measureLatency("MPSC", queue);
+	}
+
+	if(!isCorrect)
+	{
+		DAWN_ERROR("events went missing or were delivered twice");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/graphics/light_culling.h"
+#include "benchmark.h"
+
+using namespace Dawn;
+
+// CPU side of the tiled light culling: bins 256 and 1024 point lights into
+// 32 pixel tiles of a 1080p target, on the calling thread alone and with
+// workers helping, one per extra core unless given as the first argument.
+// Doesn't touch GL.
+
+namespace
+{
+	const uint32 TARGET_WIDTH = 1920;
+	const uint32 TARGET_HEIGHT = 1080;
+	const uint32 TILE_SIZE = 32;
+	const uint32 WARMUP_FRAMES = 20;
+	const uint32 FRAME_COUNT = 500;
+
+	std::vector<PointLight> makeLights(uint32 count)
+	{
+		// fixed seed, every run culls the same scene
+		std::mt19937 random(count);
+		std::uniform_real_distribution<float> x(0.0f, (float)TARGET_WIDTH);
+		std::uniform_real_distribution<float> y(0.0f, (float)TARGET_HEIGHT);
+		std::uniform_real_distribution<float> radius(32.0f, 160.0f);
+
+		std::vector<PointLight> lights(count);
+		for(auto& light : lights)
+		{
+			light.pos = glm::vec2(x(random), y(random));
+			light.radius = radius(random);
+			light.color = glm::vec3(1.0f);
+			light.intensity = 1.0f;
+		}
+		return lights;
+	}
+
+	void run(uint32 lightCount, uint32 workerCount)
+	{
+		std::vector<PointLight> lights = makeLights(lightCount);
+
+		TiledLightCuller culler;
+		culler.init(workerCount);
+		culler.setViewport(TARGET_WIDTH, TARGET_HEIGHT);
+		culler.setTileSize(TILE_SIZE);
+
+		std::vector<float> cullMs;
+		for(uint32 frame = 0; frame < WARMUP_FRAMES + FRAME_COUNT; frame++)
+		{
+			// a little movement so every frame bins a different layout
+			for(auto& light : lights)
+				light.pos.x = light.pos.x + 1.0f < TARGET_WIDTH ? light.pos.x + 1.0f : 0.0f;
+
+			culler.cull(lights);
+			if(frame >= WARMUP_FRAMES)
+				cullMs.push_back(culler.getStats().cullMs);
+		}
+		culler.shutdown();
+
+		double total = 0.0;
+		for(float ms : cullMs)
+			total += ms;
+
+		const LightCullingStats& stats = culler.getStats();
+		float average = (float)(total / cullMs.size());
+		float p99 = getPercentile(cullMs, 0.99f);
+		DAWN_INFO("{:5} lights {} workers  average {:6.3f} ms  p99 {:6.3f} ms  {:5.1f} lights per tile, max {}, {} overflowed",
+		          lightCount, workerCount, average, p99, stats.averageLightsPerTile, stats.maxLightsPerTile,
+		          stats.overflowedTiles);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+
+	uint32 workerCount = std::max<uint32>(1, std::thread::hardware_concurrency()) - 1;
+	if(argc > 1)
+		workerCount = (uint32)std::stoul(argv[1]);
+	DAWN_INFO("{}x{} target, {} pixel tiles, {} frames", TARGET_WIDTH, TARGET_HEIGHT, TILE_SIZE, FRAME_COUNT);
+
+	const uint32 lightCounts[] = { 256, 1024 };
+	for(uint32 lightCount : lightCounts)
+	{
+		run(lightCount, 0);
+		if(workerCount > 0)
+			run(lightCount, workerCount);
+	}
+	return 0;
+}
@@ -0,0 +1,272 @@
+#include <memory>
+#include <random>
+#include <vector>
+#include "core/events/events.h"
+#include "benchmark.h"
+
+using namespace Dawn;
+
+// Adds and removes listeners from inside their own callbacks while the
+// dispatcher walks the list, some of it from a nested dispatch of another
+// event type, and checks the rules the slot map promises:
+// - a listener added during a dispatch doesn't see that event
+// - a listener removed during a dispatch isn't called anymore
+// - every other listener is called exactly once, in priority order
+// - removing by a stale handle fails
+// Seeded, so a failure reproduces. Exits non-zero on the first one.
+
+namespace
+{
+	const uint32 POOL_SIZE = 1000;
+	const uint32 INITIAL_LISTENERS = 200;
+	const uint32 DISPATCH_COUNT = 100000;
+	const int32 PRIORITY_RANGE = 4;
+
+	const uint64 NEVER = ~(uint64)0;
+
+	class StressTest;
+
+	class MoveListener : public EventListener
+	{
+	public:
+		StressTest* test{};
+		ListenerHandle handle{EventDispatcher::INVALID_HANDLE};
+		bool isSubscribed{};
+		int32 priority{};
+		// dispatch it was subscribed during, NEVER if outside one
+		uint64 addedDuring{NEVER};
+		uint64 lastSeen{NEVER};
+
+		void onMouseMove(MouseMoveEvent& e) override;
+	};
+
+	// Nested dispatches of KEY_DOWN land here, in the middle of a MOUSE_MOVE one.
+	class KeyListener : public EventListener
+	{
+	public:
+		StressTest* test{};
+
+		void onKeyDown(KeyDownEvent& e) override;
+	};
+
+	class StressTest
+	{
+		std::vector<std::unique_ptr<MoveListener>> m_pool{};
+		std::vector<ListenerHandle> m_staleHandles{};
+		KeyListener m_keyListener{};
+		std::mt19937 m_random{48};
+
+		uint64 m_dispatch{};
+		bool m_isDispatching{};
+		int32 m_lastPriority{};
+		uint32 m_subscribedCount{};
+
+		uint64 m_calls{};
+		uint64 m_added{};
+		uint64 m_removed{};
+		uint64 m_nested{};
+		bool m_hasFailed{};
+
+		inline uint32 roll(uint32 sides) { return m_random() % sides; }
+
+		void fail(const char* what)
+		{
+			if(!m_hasFailed)
+				DAWN_ERROR("dispatch {}: {}", m_dispatch, what);
+			m_hasFailed = true;
+		}
+
+		MoveListener* pick(bool isSubscribed)
+		{
+			// a few tries are enough, the pool is never close to all or nothing
+			for(uint32 i = 0; i < 16; i++)
+			{
+				MoveListener* listener = m_pool[roll(POOL_SIZE)].get();
+				if(listener->isSubscribed == isSubscribed)
+					return listener;
+			}
+			return nullptr;
+		}
+
+		void add(MoveListener& listener)
+		{
+			listener.priority = (int32)roll(PRIORITY_RANGE);
+			listener.handle = EventDispatcher::getEventDispatcher().addEventListener(&listener, Event::MOUSE_MOVE, listener.priority);
+			listener.isSubscribed = true;
+			listener.addedDuring = m_isDispatching ? m_dispatch : NEVER;
+			m_subscribedCount++;
+			m_added++;
+		}
+
+		void remove(MoveListener& listener)
+		{
+			EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+			// both ways of removing, the handle one has to report success
+			if(roll(2) == 0)
+			{
+				if(!eventDispatcher.removeEventListener(listener.handle))
+					fail("removing a live handle failed");
+			}
+			else
+			{
+				eventDispatcher.removeEventListener(&listener);
+			}
+
+			m_staleHandles.push_back(listener.handle);
+			listener.isSubscribed = false;
+			m_subscribedCount--;
+			m_removed++;
+		}
+
+		void mutate()
+		{
+			uint32 action = roll(100);
+			if(action < 1)
+			{
+				if(MoveListener* listener = pick(true))
+					remove(*listener);
+			}
+			else if(action < 3)
+			{
+				if(MoveListener* listener = pick(false))
+					add(*listener);
+			}
+			else if(action < 4 && !m_staleHandles.empty())
+			{
+				if(EventDispatcher::getEventDispatcher().removeEventListener(m_staleHandles[roll((uint32)m_staleHandles.size())]))
+					fail("removing a stale handle succeeded");
+			}
+		}
+
+	public:
+		StressTest()
+		{
+			for(uint32 i = 0; i < POOL_SIZE; i++)
+			{
+				m_pool.emplace_back(new MoveListener());
+				m_pool.back()->test = this;
+			}
+			for(uint32 i = 0; i < INITIAL_LISTENERS; i++)
+				add(*m_pool[i]);
+
+			m_keyListener.test = this;
+			EventDispatcher::getEventDispatcher().addEventListener(&m_keyListener, Event::KEY_DOWN);
+		}
+
+		~StressTest()
+		{
+			EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+			for(auto& listener : m_pool)
+				eventDispatcher.removeEventListener(listener.get());
+			eventDispatcher.removeEventListener(&m_keyListener);
+		}
+
+		void onMove(MoveListener& listener)
+		{
+			m_calls++;
+			if(!listener.isSubscribed)
+				fail("a removed listener was called");
+			if(listener.addedDuring == m_dispatch)
+				fail("a listener was called by the dispatch it was added during");
+			if(listener.lastSeen == m_dispatch)
+				fail("a listener was called twice");
+			if(listener.priority > m_lastPriority)
+				fail("listeners were called out of priority order");
+
+			listener.lastSeen = m_dispatch;
+			m_lastPriority = listener.priority;
+
+			// the listener itself goes now and then, besides what mutate() does to others
+			if(roll(100) < 1)
+			{
+				remove(listener);
+				return;
+			}
+
+			mutate();
+
+			if(roll(1000) == 0)
+			{
+				KeyDownEvent keyDown;
+				keyDown.keyCode = 1;
+				m_nested++;
+				EventDispatcher::getEventDispatcher().dispatchEvent(keyDown);
+			}
+		}
+
+		void onKey()
+		{
+			// deferred like the outer dispatch's own changes
+			for(uint32 i = 0; i < 4; i++)
+				mutate();
+		}
+
+		bool run()
+		{
+			EventDispatcher& eventDispatcher = EventDispatcher::getEventDispatcher();
+			std::vector<MoveListener*> expected;
+
+			for(m_dispatch = 0; m_dispatch < DISPATCH_COUNT && !m_hasFailed; m_dispatch++)
+			{
+				// keeps the population around its start, changes outside a dispatch apply at once
+				if(m_subscribedCount > INITIAL_LISTENERS * 3 / 2)
+				{
+					if(MoveListener* listener = pick(true))
+						remove(*listener);
+				}
+				else if(m_subscribedCount < INITIAL_LISTENERS / 2)
+				{
+					if(MoveListener* listener = pick(false))
+						add(*listener);
+				}
+
+				expected.clear();
+				for(auto& listener : m_pool)
+				{
+					if(listener->isSubscribed)
+						expected.push_back(listener.get());
+				}
+
+				MouseMoveEvent event;
+				m_isDispatching = true;
+				m_lastPriority = PRIORITY_RANGE;
+				eventDispatcher.dispatchEvent(event);
+				m_isDispatching = false;
+
+				// whoever was there before and wasn't removed got it, a removed and
+				// re-added one is a new subscription and may have missed it
+				for(MoveListener* listener : expected)
+				{
+					if(listener->isSubscribed && listener->addedDuring != m_dispatch && listener->lastSeen != m_dispatch)
+						fail("a listener missed the event");
+				}
+			}
+
+			DAWN_INFO("{} dispatches, {} calls, {} listeners added, {} removed, {} nested dispatches, {} subscribed at the end",
+			          m_dispatch, m_calls, m_added, m_removed, m_nested, m_subscribedCount);
+			return !m_hasFailed;
+		}
+	};
+
+	void MoveListener::onMouseMove(MouseMoveEvent& e)
+	{
+		test->onMove(*this);
+	}
+
+	void KeyListener::onKeyDown(KeyDownEvent& e)
+	{
+		test->onKey();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+
+	StressTest test;
+	if(!test.run())
+		return 1;
+
+	DAWN_INFO("every dispatch kept the listener rules");
+	return 0;
+}
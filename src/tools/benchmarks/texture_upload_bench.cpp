@@ -0,0 +1,142 @@
+#include <vector>
+#include <SDL.h>
+#include <glad/glad.h>
+#include "core/graphics/texture_upload_queue.h"
+#include "benchmark.h"
+
+using namespace Dawn;
+
+// Frame times while textures stream in during play, uploaded with
+// glTexImage2D on the frame against through the PBO upload queue. Opens a
+// hidden window, so it needs a display with GLES 3.
+
+namespace
+{
+	const uint32 TEXTURE_COUNT = 32;
+	const uint32 TEXTURE_SIZE = 1024;
+	const uint32 CHANNELS = 4;
+	// textures requested per frame until all are
+	const uint32 TEXTURES_PER_FRAME = 4;
+	const uint32 FRAME_COUNT = 120;
+
+	void report(const char* name, std::vector<float>& frameMs, uint32 residentFrame)
+	{
+		double total = 0.0;
+		for(float ms : frameMs)
+			total += ms;
+
+		float average = (float)(total / frameMs.size());
+		float maxMs = *std::max_element(frameMs.begin(), frameMs.end());
+		float p99 = getPercentile(frameMs, 0.99f);
+		DAWN_INFO("{:<10} average {:6.2f} ms  p99 {:6.2f} ms  max {:6.2f} ms  all resident after frame {}",
+		          name, average, p99, maxMs, residentFrame);
+	}
+
+	void runSynchronous(SDL_Window* window, const std::vector<uint8>& pixels)
+	{
+		std::vector<GLuint> textures;
+		std::vector<float> frameMs;
+		uint32 residentFrame = 0;
+
+		for(uint32 frame = 0; frame < FRAME_COUNT; frame++)
+		{
+			BenchmarkClock::time_point start = BenchmarkClock::now();
+
+			for(uint32 i = 0; i < TEXTURES_PER_FRAME && textures.size() < TEXTURE_COUNT; i++)
+			{
+				GLuint texture = 0;
+				glGenTextures(1, &texture);
+				glBindTexture(GL_TEXTURE_2D, texture);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TEXTURE_SIZE, TEXTURE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+				textures.push_back(texture);
+
+				if(textures.size() == TEXTURE_COUNT)
+					residentFrame = frame;
+			}
+
+			glClear(GL_COLOR_BUFFER_BIT);
+			SDL_GL_SwapWindow(window);
+			frameMs.push_back((float)getElapsedMs(start));
+		}
+
+		glDeleteTextures((GLsizei)textures.size(), textures.data());
+		report("glTexImage2D", frameMs, residentFrame);
+	}
+
+	void runQueued(SDL_Window* window, const std::vector<uint8>& pixels)
+	{
+		TextureUploadQueue queue;
+		queue.init(2);
+
+		std::vector<CompletedUpload> completed;
+		std::vector<float> frameMs;
+		uint32 requested = 0;
+		uint32 residentFrame = 0;
+
+		for(uint32 frame = 0; frame < FRAME_COUNT; frame++)
+		{
+			BenchmarkClock::time_point start = BenchmarkClock::now();
+
+			for(uint32 i = 0; i < TEXTURES_PER_FRAME && requested < TEXTURE_COUNT; i++)
+				queue.enqueue(requested++, pixels.data(), TEXTURE_SIZE, TEXTURE_SIZE, CHANNELS);
+
+			size_t before = completed.size();
+			queue.update(completed);
+			if(before < TEXTURE_COUNT && completed.size() == TEXTURE_COUNT)
+				residentFrame = frame;
+
+			glClear(GL_COLOR_BUFFER_BIT);
+			SDL_GL_SwapWindow(window);
+			frameMs.push_back((float)getElapsedMs(start));
+		}
+
+		for(auto& upload : completed)
+			glDeleteTextures(1, &upload.texture);
+		queue.shutdown();
+
+		report("PBO queue", frameMs, completed.size() == TEXTURE_COUNT ? residentFrame : FRAME_COUNT);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+
+	if(SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		DAWN_ERROR("SDL initialization failed: {}", SDL_GetError());
+		return 1;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+
+	SDL_Window* window = SDL_CreateWindow("texture_upload_bench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+	                                      640, 480, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+	if(context == nullptr || !gladLoadGLES2Loader(SDL_GL_GetProcAddress))
+	{
+		DAWN_ERROR("Couldn't create a GLES 3 context: {}", SDL_GetError());
+		return 1;
+	}
+
+	// the swap shouldn't hide the upload cost behind the refresh interval
+	SDL_GL_SetSwapInterval(0);
+
+	std::vector<uint8> pixels((size_t)TEXTURE_SIZE * TEXTURE_SIZE * CHANNELS);
+	for(size_t i = 0; i < pixels.size(); i++)
+		pixels[i] = (uint8)(i * 31);
+
+	DAWN_INFO("{} textures of {}x{}, {} requested per frame, {} frames", TEXTURE_COUNT, TEXTURE_SIZE, TEXTURE_SIZE,
+	          TEXTURES_PER_FRAME, FRAME_COUNT);
+	runSynchronous(window, pixels);
+	runQueued(window, pixels);
+
+	SDL_GL_DeleteContext(context);
+	SDL_DestroyWindow(window);
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,134 @@
+#include <random>
+#include <vector>
+#include "core/timer_wheel.h"
+#include "benchmark.h"
+
+using namespace Dawn;
+
+// One million active timers in the TimerWheel, delays up to ten minutes of
+// millisecond ticks and a tenth of them repeating, driven by a minute of
+// 60 fps frames. Times scheduling, the per frame advance() and cancelling,
+// checks every timer fired as often as it should, and compares the advance
+// against scanning an array of expiries every frame.
+
+namespace
+{
+	const uint32 TIMER_COUNT = 1000000;
+	const uint64 MAX_DELAY_MS = 10 * 60 * 1000;
+	const uint32 FRAME_MS = 16;
+	const uint32 FRAME_COUNT = 60 * 1000 / FRAME_MS;
+	// frames of the array scan, it's slow enough that a few give a stable number
+	const uint32 SCAN_FRAME_COUNT = 60;
+
+	struct TimerSpec
+	{
+		uint64 delay;
+		uint32 period;
+	};
+
+	uint64 getExpectedFires(const TimerSpec& spec, uint64 end)
+	{
+		if(spec.delay > end)
+			return 0;
+		return spec.period == 0 ? 1 : (end - spec.delay) / spec.period + 1;
+	}
+
+	float getAverage(const std::vector<float>& samples)
+	{
+		double total = 0.0;
+		for(float sample : samples)
+			total += sample;
+		return samples.empty() ? 0.0f : (float)(total / samples.size());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+
+	std::mt19937 random(40);
+	std::uniform_int_distribution<uint64> delay(1, MAX_DELAY_MS);
+	std::uniform_int_distribution<uint32> period(100, 5000);
+
+	std::vector<TimerSpec> specs(TIMER_COUNT);
+	for(uint32 i = 0; i < TIMER_COUNT; i++)
+	{
+		specs[i].delay = delay(random);
+		specs[i].period = i % 10 == 0 ? period(random) : 0;
+	}
+
+	TimerWheel timers;
+	std::vector<TimerHandle> handles(TIMER_COUNT);
+	uint64 fired = 0;
+
+	BenchmarkClock::time_point start = BenchmarkClock::now();
+	for(uint32 i = 0; i < TIMER_COUNT; i++)
+		handles[i] = timers.scheduleRepeating(specs[i].delay, specs[i].period, [&fired]() { fired++; });
+	double scheduleMs = getElapsedMs(start);
+	DAWN_INFO("schedule  {} timers in {:.1f} ms, {:.0f} ns each", TIMER_COUNT, scheduleMs, scheduleMs * 1e6 / TIMER_COUNT);
+
+	std::vector<float> advanceMs;
+	uint32 maxFired = 0;
+	for(uint32 frame = 1; frame <= FRAME_COUNT; frame++)
+	{
+		start = BenchmarkClock::now();
+		timers.advance((uint64)frame * FRAME_MS);
+		advanceMs.push_back((float)getElapsedMs(start));
+		maxFired = std::max(maxFired, timers.getStats().fired);
+	}
+
+	uint64 end = (uint64)FRAME_COUNT * FRAME_MS;
+	uint64 expected = 0;
+	for(const TimerSpec& spec : specs)
+		expected += getExpectedFires(spec, end);
+
+	float average = getAverage(advanceMs);
+	float maxMs = *std::max_element(advanceMs.begin(), advanceMs.end());
+	float p99 = getPercentile(advanceMs, 0.99f);
+	DAWN_INFO("advance   {} frames of {} ms, average {:.3f} ms  p99 {:.3f} ms  max {:.3f} ms, up to {} fired in a frame",
+	          FRAME_COUNT, FRAME_MS, average, p99, maxMs, maxFired);
+
+	uint32 active = timers.getActiveCount();
+	start = BenchmarkClock::now();
+	uint32 cancelled = 0;
+	for(TimerHandle handle : handles)
+		cancelled += timers.cancel(handle) ? 1 : 0;
+	double cancelMs = getElapsedMs(start);
+	DAWN_INFO("cancel    {} active timers in {:.1f} ms, {:.0f} ns each", cancelled, cancelMs,
+	          cancelled ? cancelMs * 1e6 / cancelled : 0.0);
+
+	// what the wheel replaces: every frame looks at every timer
+	std::vector<uint64> expiries(TIMER_COUNT);
+	for(uint32 i = 0; i < TIMER_COUNT; i++)
+		expiries[i] = specs[i].delay;
+
+	std::vector<float> scanMs;
+	for(uint32 frame = 1; frame <= SCAN_FRAME_COUNT; frame++)
+	{
+		start = BenchmarkClock::now();
+		uint64 now = (uint64)frame * FRAME_MS;
+		uint32 due = 0;
+		for(uint64& expiry : expiries)
+		{
+			if(expiry <= now)
+			{
+				expiry = UINT64_MAX;
+				due++;
+			}
+		}
+		keepAlive(due);
+		scanMs.push_back((float)getElapsedMs(start));
+	}
+	DAWN_INFO("scan      average {:.3f} ms per frame over the array", getAverage(scanMs));
+
+	bool isCorrect = fired == expected && cancelled == active && timers.getActiveCount() == 0;
+	if(!isCorrect)
+	{
+		DAWN_ERROR("fired {} of {} expected, cancelled {} of {} active, {} left", fired, expected, cancelled, active,
+		           timers.getActiveCount());
+		return 1;
+	}
+
+	DAWN_INFO("fired {} callbacks as expected", fired);
+	return 0;
+}
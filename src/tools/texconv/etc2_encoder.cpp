@@ -0,0 +1,336 @@
+#include "etc2_encoder.h"
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include "core/graphics/compressed_texture.h"
+
+namespace Dawn
+{
+	namespace
+	{
+		const int ETC1_MODIFIERS[8][4] =
+		{
+			{  2,   8,  -2,   -8 },
+			{  5,  17,  -5,  -17 },
+			{  9,  29,  -9,  -29 },
+			{ 13,  42, -13,  -42 },
+			{ 18,  60, -18,  -60 },
+			{ 24,  80, -24,  -80 },
+			{ 33, 106, -33, -106 },
+			{ 47, 183, -47, -183 }
+		};
+
+		const int EAC_MODIFIERS[16][8] =
+		{
+			{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+			{ -3, -7, -10, -13, 2, 6, 9, 12 },
+			{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+			{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+			{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+			{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+			{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+			{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+			{ -2, -6,  -8, -10, 1, 5, 7,  9 },
+			{ -2, -5,  -8, -10, 1, 4, 7,  9 },
+			{ -2, -4,  -8, -10, 1, 3, 7,  9 },
+			{ -2, -5,  -7, -10, 1, 4, 6,  9 },
+			{ -3, -4,  -7, -10, 2, 3, 6,  9 },
+			{ -1, -2,  -3, -10, 0, 1, 2,  9 },
+			{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
+			{ -3, -5,  -7,  -9, 2, 4, 6,  8 }
+		};
+
+		// index of the zero modifier in EAC_MODIFIERS[13], used for flat blocks
+		const uint32 EAC_FLAT_TABLE = 13;
+		const uint32 EAC_FLAT_INDEX = 4;
+
+		inline int clampByte(int v)
+		{
+			return v < 0 ? 0 : (v > 255 ? 255 : v);
+		}
+
+		inline bool isInSubblock(uint32 x, uint32 y, bool flip, uint32 subblock)
+		{
+			return (flip ? y >= 2 : x >= 2) == (subblock == 1);
+		}
+
+		// Picks the modifier table and per pixel indices for one half of the block.
+		// Indices are stored ETC style, column major (x * 4 + y).
+		uint32 encodeSubblock(const uint8* rgba, bool flip, uint32 subblock, const int base[3],
+		                      uint32& table, uint8 indices[16])
+		{
+			uint32 bestError = std::numeric_limits<uint32>::max();
+			uint8 candidate[16];
+
+			for(uint32 t = 0; t < 8; t++)
+			{
+				uint32 error = 0;
+				for(uint32 y = 0; y < 4 && error < bestError; y++)
+				{
+					for(uint32 x = 0; x < 4; x++)
+					{
+						if(!isInSubblock(x, y, flip, subblock))
+							continue;
+
+						const uint8* pixel = rgba + (y * 4 + x) * 4;
+						uint32 bestPixelError = std::numeric_limits<uint32>::max();
+						for(uint32 i = 0; i < 4; i++)
+						{
+							int modifier = ETC1_MODIFIERS[t][i];
+							int dr = clampByte(base[0] + modifier) - pixel[0];
+							int dg = clampByte(base[1] + modifier) - pixel[1];
+							int db = clampByte(base[2] + modifier) - pixel[2];
+							uint32 pixelError = dr * dr + dg * dg + db * db;
+							if(pixelError < bestPixelError)
+							{
+								bestPixelError = pixelError;
+								candidate[x * 4 + y] = (uint8)i;
+							}
+						}
+						error += bestPixelError;
+					}
+				}
+
+				if(error < bestError)
+				{
+					bestError = error;
+					table = t;
+					for(uint32 y = 0; y < 4; y++)
+						for(uint32 x = 0; x < 4; x++)
+							if(isInSubblock(x, y, flip, subblock))
+								indices[x * 4 + y] = candidate[x * 4 + y];
+				}
+			}
+
+			return bestError;
+		}
+
+		inline void writeBigEndian(uint64 bits, uint8* out8)
+		{
+			for(uint32 i = 0; i < 8; i++)
+				out8[i] = (uint8)(bits >> (56 - 8 * i));
+		}
+	}
+
+	void encodeEtc2RgbBlock(const uint8* rgba, uint8* out8)
+	{
+		uint32 bestError = std::numeric_limits<uint32>::max();
+		uint64 bestBits = 0;
+
+		for(uint32 flip = 0; flip < 2; flip++)
+		{
+			float average[2][3] = {};
+			for(uint32 y = 0; y < 4; y++)
+			{
+				for(uint32 x = 0; x < 4; x++)
+				{
+					uint32 subblock = isInSubblock(x, y, flip != 0, 1) ? 1 : 0;
+					for(uint32 c = 0; c < 3; c++)
+						average[subblock][c] += rgba[(y * 4 + x) * 4 + c] / 8.0f;
+				}
+			}
+
+			// differential mode: 5 bit base plus a 3 bit signed delta
+			int quantized[2][3];
+			bool isDifferentialValid = true;
+			for(uint32 c = 0; c < 3; c++)
+			{
+				quantized[0][c] = (int)(average[0][c] * 31.0f / 255.0f + 0.5f);
+				quantized[1][c] = (int)(average[1][c] * 31.0f / 255.0f + 0.5f);
+				int delta = quantized[1][c] - quantized[0][c];
+				isDifferentialValid = isDifferentialValid && delta >= -4 && delta <= 3;
+			}
+
+			for(uint32 isDifferential = 0; isDifferential < 2; isDifferential++)
+			{
+				if(isDifferential && !isDifferentialValid)
+					continue;
+
+				int codes[2][3];
+				int base[2][3];
+				for(uint32 s = 0; s < 2; s++)
+				{
+					for(uint32 c = 0; c < 3; c++)
+					{
+						if(isDifferential)
+						{
+							codes[s][c] = quantized[s][c];
+							base[s][c] = (codes[s][c] << 3) | (codes[s][c] >> 2);
+						}
+						else
+						{
+							codes[s][c] = (int)(average[s][c] * 15.0f / 255.0f + 0.5f);
+							base[s][c] = (codes[s][c] << 4) | codes[s][c];
+						}
+					}
+				}
+
+				uint8 indices[16] = {};
+				uint32 tables[2] = {};
+				uint32 error = encodeSubblock(rgba, flip != 0, 0, base[0], tables[0], indices) +
+				               encodeSubblock(rgba, flip != 0, 1, base[1], tables[1], indices);
+				if(error >= bestError)
+					continue;
+
+				uint64 bits = 0;
+				if(isDifferential)
+				{
+					bits |= (uint64)codes[0][0] << 59 | (uint64)((codes[1][0] - codes[0][0]) & 7) << 56;
+					bits |= (uint64)codes[0][1] << 51 | (uint64)((codes[1][1] - codes[0][1]) & 7) << 48;
+					bits |= (uint64)codes[0][2] << 43 | (uint64)((codes[1][2] - codes[0][2]) & 7) << 40;
+				}
+				else
+				{
+					bits |= (uint64)codes[0][0] << 60 | (uint64)codes[1][0] << 56;
+					bits |= (uint64)codes[0][1] << 52 | (uint64)codes[1][1] << 48;
+					bits |= (uint64)codes[0][2] << 44 | (uint64)codes[1][2] << 40;
+				}
+
+				bits |= (uint64)tables[0] << 37 | (uint64)tables[1] << 34;
+				bits |= (uint64)isDifferential << 33 | (uint64)flip << 32;
+
+				for(uint32 p = 0; p < 16; p++)
+				{
+					bits |= (uint64)(indices[p] >> 1) << (16 + p);
+					bits |= (uint64)(indices[p] & 1) << p;
+				}
+
+				bestError = error;
+				bestBits = bits;
+			}
+		}
+
+		writeBigEndian(bestBits, out8);
+	}
+
+	void encodeEacAlphaBlock(const uint8* rgba, uint8* out8)
+	{
+		int minAlpha = 255;
+		int maxAlpha = 0;
+		for(uint32 p = 0; p < 16; p++)
+		{
+			minAlpha = rgba[p * 4 + 3] < minAlpha ? rgba[p * 4 + 3] : minAlpha;
+			maxAlpha = rgba[p * 4 + 3] > maxAlpha ? rgba[p * 4 + 3] : maxAlpha;
+		}
+
+		uint32 bestBase = minAlpha;
+		uint32 bestMultiplier = 1;
+		uint32 bestTable = EAC_FLAT_TABLE;
+		uint8 bestIndices[16];
+		std::memset(bestIndices, EAC_FLAT_INDEX, sizeof(bestIndices));
+
+		if(minAlpha != maxAlpha)
+		{
+			uint32 bestError = std::numeric_limits<uint32>::max();
+			uint8 indices[16];
+
+			for(uint32 t = 0; t < 16; t++)
+			{
+				int tableMin = EAC_MODIFIERS[t][3];
+				int tableMax = EAC_MODIFIERS[t][7];
+				int estimate = (maxAlpha - minAlpha + (tableMax - tableMin) / 2) / (tableMax - tableMin);
+
+				for(int multiplier = estimate - 1; multiplier <= estimate + 1; multiplier++)
+				{
+					if(multiplier < 1 || multiplier > 15)
+						continue;
+
+					int center = (minAlpha + maxAlpha) / 2 - (tableMin + tableMax) * multiplier / 2;
+					for(int base = center - 1; base <= center + 1; base++)
+					{
+						if(base < 0 || base > 255)
+							continue;
+
+						uint32 error = 0;
+						for(uint32 y = 0; y < 4 && error < bestError; y++)
+						{
+							for(uint32 x = 0; x < 4; x++)
+							{
+								int alpha = rgba[(y * 4 + x) * 4 + 3];
+								uint32 bestPixelError = std::numeric_limits<uint32>::max();
+								for(uint32 i = 0; i < 8; i++)
+								{
+									int d = clampByte(base + EAC_MODIFIERS[t][i] * multiplier) - alpha;
+									if((uint32)(d * d) < bestPixelError)
+									{
+										bestPixelError = d * d;
+										indices[x * 4 + y] = (uint8)i;
+									}
+								}
+								error += bestPixelError;
+							}
+						}
+
+						if(error < bestError)
+						{
+							bestError = error;
+							bestBase = base;
+							bestMultiplier = multiplier;
+							bestTable = t;
+							std::memcpy(bestIndices, indices, sizeof(indices));
+						}
+					}
+				}
+			}
+		}
+
+		uint64 bits = (uint64)bestBase << 56 | (uint64)bestMultiplier << 52 | (uint64)bestTable << 48;
+		for(uint32 p = 0; p < 16; p++)
+			bits |= (uint64)bestIndices[p] << (45 - 3 * p);
+
+		writeBigEndian(bits, out8);
+	}
+
+	std::vector<uint8> encodeEtc2Image(const uint8* rgba, uint32 width, uint32 height,
+	                                   bool hasAlpha, uint32 threadCount)
+	{
+		uint32 format = hasAlpha ? ETC2_RGBA8_EAC : ETC2_RGB8;
+		uint32 blockSize = getCompressedBlockSize(format);
+		uint32 blocksX = (width + 3) / 4;
+		uint32 blocksY = (height + 3) / 4;
+
+		std::vector<uint8> output(getCompressedMipSize(format, width, height));
+		std::atomic<uint32> nextRow{0};
+
+		auto encodeRows = [&]()
+		{
+			uint8 block[64];
+			for(uint32 by = nextRow++; by < blocksY; by = nextRow++)
+			{
+				for(uint32 bx = 0; bx < blocksX; bx++)
+				{
+					// replicate the edge for blocks hanging over the image border
+					for(uint32 y = 0; y < 4; y++)
+					{
+						uint32 sy = by * 4 + y < height ? by * 4 + y : height - 1;
+						for(uint32 x = 0; x < 4; x++)
+						{
+							uint32 sx = bx * 4 + x < width ? bx * 4 + x : width - 1;
+							std::memcpy(block + (y * 4 + x) * 4, rgba + (sy * width + sx) * 4, 4);
+						}
+					}
+
+					uint8* out = output.data() + (by * blocksX + bx) * blockSize;
+					if(hasAlpha)
+					{
+						encodeEacAlphaBlock(block, out);
+						out += 8;
+					}
+					encodeEtc2RgbBlock(block, out);
+				}
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for(uint32 i = 1; i < threadCount && i < blocksY; i++)
+			workers.emplace_back(encodeRows);
+
+		encodeRows();
+
+		for(auto& worker : workers)
+			worker.join();
+
+		return output;
+	}
+}
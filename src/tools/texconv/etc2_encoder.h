@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+#include "core/common.h"
+
+namespace Dawn
+{
+	// Encodes one 4x4 block of RGBA8 pixels (row major, 64 bytes).
+	// RGB is written as an ETC1-compatible ETC2 block (individual/differential
+	// modes), alpha as an EAC block placed in front of it.
+	void encodeEtc2RgbBlock(const uint8* rgba, uint8* out8);
+	void encodeEacAlphaBlock(const uint8* rgba, uint8* out8);
+
+	// Encodes a whole image, splitting block rows across threadCount threads.
+	// Returns getCompressedMipSize() bytes for the requested format.
+	std::vector<uint8> encodeEtc2Image(const uint8* rgba, uint32 width, uint32 height,
+	                                   bool hasAlpha, uint32 threadCount);
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stb_image.h>
+#include "core/log.h"
+#include "core/graphics/compressed_texture.h"
+#include "etc2_encoder.h"
+
+using namespace Dawn;
+
+namespace
+{
+	void printUsage()
+	{
+		DAWN_INFO("usage: texconv [-j threads] [--no-mips] [--no-alpha] <input.png> <output.dtex>");
+	}
+
+	// 2x2 box filter, odd edges reuse the last row/column
+	std::vector<uint8> downsample(const std::vector<uint8>& rgba, uint32 width, uint32 height)
+	{
+		uint32 mipWidth = width > 1 ? width / 2 : 1;
+		uint32 mipHeight = height > 1 ? height / 2 : 1;
+		std::vector<uint8> mip(mipWidth * mipHeight * 4);
+
+		for(uint32 y = 0; y < mipHeight; y++)
+		{
+			uint32 y0 = y * 2;
+			uint32 y1 = y0 + 1 < height ? y0 + 1 : y0;
+			for(uint32 x = 0; x < mipWidth; x++)
+			{
+				uint32 x0 = x * 2;
+				uint32 x1 = x0 + 1 < width ? x0 + 1 : x0;
+				for(uint32 c = 0; c < 4; c++)
+				{
+					uint32 sum = rgba[(y0 * width + x0) * 4 + c] + rgba[(y0 * width + x1) * 4 + c] +
+					             rgba[(y1 * width + x0) * 4 + c] + rgba[(y1 * width + x1) * 4 + c];
+					mip[(y * mipWidth + x) * 4 + c] = (uint8)((sum + 2) / 4);
+				}
+			}
+		}
+
+		return mip;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Log::initLog();
+
+	uint32 threadCount = std::thread::hardware_concurrency();
+	bool generateMips = true;
+	bool allowAlpha = true;
+	std::vector<std::string> paths;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			threadCount = (uint32)std::atoi(argv[++i]);
+		else if(std::strcmp(argv[i], "--no-mips") == 0)
+			generateMips = false;
+		else if(std::strcmp(argv[i], "--no-alpha") == 0)
+			allowAlpha = false;
+		else
+			paths.push_back(argv[i]);
+	}
+
+	if(paths.size() != 2)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	if(threadCount == 0)
+		threadCount = 1;
+
+	int x, y, n;
+	stbi_uc* pixels = stbi_load(paths[0].c_str(), &x, &y, &n, 4);
+	if(pixels == nullptr)
+	{
+		DAWN_ERROR("Couldn't load {}: {}", paths[0], stbi_failure_reason());
+		return EXIT_FAILURE;
+	}
+
+	uint32 width = x;
+	uint32 height = y;
+	std::vector<uint8> rgba(pixels, pixels + width * height * 4);
+	stbi_image_free(pixels);
+
+	// grey + alpha and rgba sources keep their alpha channel
+	bool hasAlpha = allowAlpha && (n == 2 || n == 4);
+
+	CompressedTexture texture;
+	texture.header.format = hasAlpha ? ETC2_RGBA8_EAC : ETC2_RGB8;
+	texture.header.width = width;
+	texture.header.height = height;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	uint64 uncompressedBytes = 0;
+	uint64 compressedBytes = 0;
+
+	while(true)
+	{
+		texture.mips.push_back(encodeEtc2Image(rgba.data(), width, height, hasAlpha, threadCount));
+		uncompressedBytes += width * height * (hasAlpha ? 4 : 3);
+		compressedBytes += texture.mips.back().size();
+
+		if(!generateMips || (width == 1 && height == 1))
+			break;
+
+		rgba = downsample(rgba, width, height);
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+
+	texture.header.mipCount = (uint32)texture.mips.size();
+	std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	if(!writeCompressedTexture(paths[1], texture))
+	{
+		DAWN_ERROR("Couldn't write {}", paths[1]);
+		return EXIT_FAILURE;
+	}
+
+	DAWN_INFO("{} -> {}: {}x{} {} with {} mips, {} -> {} bytes ({:.1f}x) in {:.1f} ms on {} threads",
+	          paths[0], paths[1], texture.header.width, texture.header.height,
+	          hasAlpha ? "ETC2_RGBA8_EAC" : "ETC2_RGB8", texture.header.mipCount,
+	          uncompressedBytes, compressedBytes, (float)uncompressedBytes / compressedBytes,
+	          elapsed.count(), threadCount);
+
+	return EXIT_SUCCESS;
+}